@@ -1,6 +1,11 @@
 #pragma once
 
+#include <array>
+#include <limits>
 #include <set>
+#include <span>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
 #include "Utility.h"
@@ -20,6 +25,11 @@ namespace RE {
     class TESObjectARMO;
 }
 
+namespace Forms {
+    class FormReferenceWriter;
+    class ResolutionContext;
+}
+
 enum class InventoryManagementMode : std::uint32_t {
     Automatic = 1,
     Immersive = 2
@@ -72,8 +82,55 @@ struct WeatherFlags {
     bool rainy = false;
 };
 
+// Bits describing what an actor is doing and where it is, used by the location priority ladder.
+// Keyword alternatives (e.g. a city also counts as a town) are folded in when the bits are built.
+namespace LocationContext {
+    enum : std::uint32_t {
+        kNone = 0,
+        // Actor state
+        kInterior = 1 << 0,
+        kLoveScene = 1 << 1,
+        kMounted = 1 << 2,
+        kSwimming = 1 << 3,
+        kSleeping = 1 << 4,
+        kInWater = 1 << 5,
+        kInCombat = 1 << 6,
+        // World state
+        kSnowy = 1 << 7,
+        kRainy = 1 << 8,
+        kNight = 1 << 9,
+        // Location keywords
+        kCity = 1 << 10,
+        kTownOrCity = 1 << 11,
+        kPlayerHouse = 1 << 12,
+        kCastle = 1 << 13,
+        kTemple = 1 << 14,
+        kGuild = 1 << 15,
+        kJail = 1 << 16,
+        kFarm = 1 << 17,
+        kMilitary = 1 << 18,
+        kInn = 1 << 19,
+        kStore = 1 << 20,
+        kDungeon = 1 << 21,
+    };
+}
+
+// Structure-of-arrays input for ArmorAddonOverrideService::classifyActors. Entry i of every array describes the same actor.
+struct ActorContextBatch {
+    std::vector<RE::Actor*> actors;
+    std::vector<std::uint32_t> contextBits;    // LocationContext flags
+    std::vector<std::uint32_t> assignmentMasks;// one bit per LocationType the actor has an outfit for, see locationTypeBit
+    std::vector<LocationType> results;
+    std::vector<std::uint8_t> resolved;
+
+    void clear();
+    void reserve(std::size_t count);
+    void push(RE::Actor* actor, std::uint32_t context, std::uint32_t assignmentMask);
+    std::size_t size() const noexcept { return actors.size(); }
+};
+
 struct Outfit {
-    Outfit(const proto::Outfit& proto, const SKSE::SerializationInterface* intfc);
+    Outfit(const proto::Outfit& proto, Forms::ResolutionContext& forms);
     Outfit(const char* n) : m_name(n), m_favorited(false){};
     Outfit(const Outfit& other) = default;
     Outfit(const char* n, const Outfit& other) : m_name(n), m_favorited(false) {
@@ -82,12 +139,26 @@ struct Outfit {
     std::string m_name;// can't be const; prevents assigning to Outfit vars
     std::unordered_set<RE::TESObjectARMO*> m_armors;
     bool m_favorited;
+    std::string m_libraryFile;// set while m_armors hasn't been read from the outfit library yet; see OutfitLibrary
+    bool m_fromGlobalLibrary = false;   // listed from the global outfit library; see GlobalOutfitLibrary
+    bool m_globalLibraryPending = false;// m_armors hasn't been read from the global outfit library yet
+    bool m_globalLibraryCopy = false;   // unchanged since attachGlobalLibrary, so left out of saves; see markChanged
+    RE::BSFixedString m_papyrusName;    // m_name interned in the game's string table; kept current by OutfitMap
+
+    bool isPending() const noexcept { return !m_libraryFile.empty() || m_globalLibraryPending; }
+    // Call after changing m_armors; OutfitMap::setFavorite calls it for the favorite flag. Saves check the flag this
+    // clears rather than comparing every outfit against the global library again.
+    void markChanged() noexcept { m_globalLibraryCopy = false; }
+    // The name as Papyrus receives it. Outfits in an OutfitMap reuse one handle instead of looking the name up in the
+    // game's string table on every call.
+    RE::BSFixedString papyrusName() const { return m_papyrusName.empty() && !m_name.empty() ? RE::BSFixedString(m_name.c_str()) : m_papyrusName; }
 
     bool conflictsWith(RE::TESObjectARMO*) const;
     bool hasShield() const;
     std::unordered_set<RE::TESObjectARMO*> computeDisplaySet(const std::unordered_set<RE::TESObjectARMO*>& equippedSet);
 
-    proto::Outfit save() const;// can throw ArmorAddonOverrideService::save_error
+    proto::Outfit save(Forms::FormReferenceWriter& refs) const;// can throw ArmorAddonOverrideService::save_error
+    proto::Outfit saveForExport() const;                        // v1 "0x1a2b|Plugin.esp" strings; see ArmorAddonOverrideService::saveForExport
 
     bool operator==(const Outfit& rhs) const
     {
@@ -97,6 +168,139 @@ struct Outfit {
                m_favorited == rhs.m_favorited;
     }
 };
+// An outfit's name as a map key: compares case-insensitively and carries its case-folded hash, which is computed
+// once when the key is made rather than on every rehash or lookup by key.
+struct OutfitName : cobb::istring {
+    OutfitName(const char* name) : cobb::istring(name), hash(Hash()(std::string_view(name))) {}
+    OutfitName(std::string_view name) : cobb::istring(name.data(), name.size()), hash(Hash()(name)) {}
+    OutfitName(const cobb::istring& name) : cobb::istring(name), hash(Hash()(name)) {}
+    std::size_t hash;
+
+    static std::string_view View(std::string_view name) noexcept { return name; }
+    static std::string_view View(const char* name) noexcept { return name; }
+    static std::string_view View(const cobb::istring& name) noexcept { return {name.data(), name.size()}; }
+
+    // Both accept plain strings as well, so lookups by name don't have to build a key first.
+    struct Hash {
+        using is_transparent = void;
+        std::size_t operator()(const OutfitName& name) const noexcept { return name.hash; }
+        std::size_t operator()(std::string_view name) const noexcept;
+        std::size_t operator()(const char* name) const noexcept { return (*this)(std::string_view(name)); }
+        std::size_t operator()(const cobb::istring& name) const noexcept { return (*this)(View(name)); }
+    };
+    struct Equal {
+        using is_transparent = void;
+        bool operator()(const OutfitName& a, const OutfitName& b) const noexcept {
+            return a.hash == b.hash && a.compare(b) == 0;
+        }
+        template <typename A, typename B>
+        bool operator()(const A& a, const B& b) const noexcept {
+            const auto x = View(a);
+            const auto y = View(b);
+            return x.size() == y.size() && cobb::utf8::compare_folded(x.data(), y.data(), x.size()) == 0;
+        }
+    };
+};
+
+// Outfits by name. Lookups hash the case-folded name; listings walk a separately kept natural order (and a second one
+// of just the favorites), which every insertion, removal and setFavorite here updates in O(log n). Iterating the map
+// itself visits outfits in no particular order. Inserting an outfit also interns its Papyrus name, so a rename (which
+// re-inserts) refreshes the handle and an erase releases it.
+class OutfitMap {
+    using map_type = std::unordered_map<OutfitName, Outfit, OutfitName::Hash, OutfitName::Equal>;
+
+public:
+    using value_type = map_type::value_type;
+    using iterator = map_type::iterator;
+    using const_iterator = map_type::const_iterator;
+    using node_type = map_type::node_type;
+    using insert_return_type = map_type::insert_return_type;
+
+    struct SortedEntry {
+        std::string key;// natural collation key of the name
+        value_type* outfit;
+    };
+    struct SortedLess {
+        bool operator()(const SortedEntry& a, const SortedEntry& b) const noexcept;
+    };
+    using sorted_type = std::set<SortedEntry, SortedLess>;
+
+    OutfitMap() = default;
+    OutfitMap(const OutfitMap& other) : m_map(other.m_map) { rebuildOrder(); }
+    OutfitMap(OutfitMap&&) = default;// moving keeps the nodes, so the order's pointers stay valid
+    OutfitMap& operator=(const OutfitMap& other);
+    OutfitMap& operator=(OutfitMap&&) = default;
+
+    iterator begin() noexcept { return m_map.begin(); }
+    iterator end() noexcept { return m_map.end(); }
+    const_iterator begin() const noexcept { return m_map.begin(); }
+    const_iterator end() const noexcept { return m_map.end(); }
+    const_iterator cbegin() const noexcept { return m_map.cbegin(); }
+    const_iterator cend() const noexcept { return m_map.cend(); }
+    std::size_t size() const noexcept { return m_map.size(); }
+    bool empty() const noexcept { return m_map.empty(); }
+    const sorted_type& sorted() const noexcept { return m_sorted; }// every outfit, in natural order of its name
+    const sorted_type& favorites() const noexcept { return m_favorites; }
+    // Favorites have to be changed through here once an outfit is in the map, or the favorites order goes stale.
+    void setFavorite(value_type& outfit, bool favorite);
+
+    template <typename K>
+    iterator find(const K& name) { return m_map.find(name); }
+    template <typename K>
+    const_iterator find(const K& name) const { return m_map.find(name); }
+    template <typename K>
+    bool contains(const K& name) const { return m_map.contains(name); }
+    template <typename K>
+    Outfit& at(const K& name) {
+        auto it = m_map.find(name);
+        if (it == m_map.end())
+            throw std::out_of_range("No outfit with this name.");
+        return it->second;
+    }
+
+    template <typename... Args>
+    std::pair<iterator, bool> emplace(Args&&... args) {
+        auto result = m_map.emplace(std::forward<Args>(args)...);
+        if (result.second)
+            addToOrder(*result.first);
+        return result;
+    }
+    template <typename K, typename... Args>
+    std::pair<iterator, bool> try_emplace(const K& name, Args&&... args) {
+        auto result = m_map.try_emplace(OutfitName(name), std::forward<Args>(args)...);
+        if (result.second)
+            addToOrder(*result.first);
+        return result;
+    }
+    insert_return_type insert(node_type&& node);
+    template <typename K>
+    std::size_t erase(const K& name) {
+        auto it = m_map.find(name);
+        if (it == m_map.end())
+            return 0;
+        removeFromOrder(*it);
+        m_map.erase(it);
+        return 1;
+    }
+    template <typename K>
+    node_type extract(const K& name) {
+        auto it = m_map.find(name);
+        if (it == m_map.end())
+            return {};
+        removeFromOrder(*it);
+        return m_map.extract(it);
+    }
+
+private:
+    map_type m_map;
+    sorted_type m_sorted;
+    sorted_type m_favorites;
+
+    void addToOrder(value_type& outfit);
+    void removeFromOrder(value_type& outfit);
+    void rebuildOrder();
+};
+
 const constexpr char* g_noOutfitName = "";
 static Outfit g_noOutfit(g_noOutfitName);// can't be const; prevents us from assigning it to Outfit&s
 
@@ -106,11 +310,16 @@ public:
     ArmorAddonOverrideService(const proto::OutfitSystem& data, const SKSE::SerializationInterface* intfc);// can throw load_error
     typedef Outfit Outfit;
     static constexpr std::uint32_t signature = 'AAOS';
+    static constexpr std::uint32_t outfitChunkSignature = 'AAOC';
+    static constexpr std::uint32_t assignmentsSignature = 'AAOA';
     enum {
-        kSaveVersionV1 = 1,
+        kSaveVersionV1 = 1,// forms stored as "0x1a2b|Plugin.esp" strings
+        kSaveVersionV2 = 2,// forms stored as plugin table index + local form ID
+        kSaveVersionV3 = 3,// settings, outfit chunks and assignments stored as separate records
     };
     //
     static constexpr std::uint32_t ce_outfitNameMaxLength = 256;// SKSE caps serialized std::strings and const char*s to 256 bytes.
+    static constexpr std::size_t ce_outfitChunkCount = 64;      // outfits are bucketed into chunks by a hash of their name
     //
     static void _validateNameOrThrow(const char* outfitName);
     //
@@ -147,8 +356,9 @@ public:
     bool climatePriorityEnabled  = false;
     InventoryManagementMode playerInventoryManagementMode = InventoryManagementMode::Automatic;
     InventoryManagementMode npcInventoryManagementMode = InventoryManagementMode::Automatic;
-    std::map<cobb::istring, Outfit> outfits;
+    OutfitMap outfits;
     std::map<RE::Actor*, ActorOutfitAssignments> actorOutfitAssignments;
+    std::set<cobb::istring> hiddenLibraryOutfits;// global library outfits deleted in this save
 
     static ArmorAddonOverrideService& GetInstance() {
         static ArmorAddonOverrideService instance;
@@ -157,9 +367,13 @@ public:
     //
     Outfit& getOutfit(const char* name);        // throws std::out_of_range if not found
     Outfit& getOrCreateOutfit(const char* name);// can throw bad_name
+    static Outfit& materialize(Outfit& outfit); // reads the outfit's armors from the outfit library if still pending
+    void attachGlobalLibrary();                 // lists the global library's outfits that this save doesn't override
+    static bool isGlobalLibraryCopy(const Outfit& outfit) noexcept { return outfit.m_globalLibraryCopy; }// so not saved
     //
     void addOutfit(const char* name);                                        // can throw bad_name
     void addOutfit(const char* name, std::vector<RE::TESObjectARMO*> armors);// can throw bad_name
+    void overwriteOutfit(const char* name, std::span<RE::TESObjectARMO* const> armors);// creates the outfit if needed and replaces its armors, skipping None; can throw bad_name
     Outfit& currentOutfit(RE::Actor* target);
     bool hasOutfit(const char* name) const;
     void deleteOutfit(const char* name);
@@ -175,10 +389,21 @@ public:
     void setLocationOutfit(LocationType location, const char* name, RE::Actor* target);
     void unsetLocationOutfit(LocationType location, RE::Actor* target);
     std::optional<cobb::istring> getLocationOutfit(LocationType location, RE::Actor* target);
+    RE::BSFixedString getLocationOutfitName(LocationType location, RE::Actor* target) const;// empty if none is assigned
     std::optional<LocationType> checkLocationType(const std::unordered_set<std::string>& keywords, const WeatherFlags& weather_flags, const GameDayPart& day_part, RE::Actor* target);
+    std::span<const LocationType> classifyActors(ActorContextBatch& batch) const;// evaluates the priority ladder for every actor in the batch at once
+    //
+    static std::uint32_t locationTypeBit(LocationType location) noexcept;
+    static std::uint32_t locationContextFromKeywords(const std::unordered_set<std::string>& keywords) noexcept;
+    static std::uint32_t locationContextFromWorld(const WeatherFlags& weather_flags, const GameDayPart& day_part) noexcept;
+    static std::uint32_t locationContextForActor(RE::Actor* target);
+    std::uint32_t assignmentMaskForActor(RE::Actor* target) const;
     //
     bool shouldOverride(RE::Actor* target) const noexcept;
-    void getOutfitNames(std::vector<std::string>& out, bool favoritesOnly = false) const;
+    // One page of outfit names in natural order, as their interned Papyrus handles.
+    void getOutfitNames(std::vector<RE::BSFixedString>& out, bool favoritesOnly = false, std::size_t offset = 0,
+                        std::size_t limit = std::numeric_limits<std::size_t>::max()) const;
+    std::size_t countOutfits(bool favoritesOnly) const noexcept;
     void setEnabled(bool) noexcept;
     void setQuickslotEnabled(bool) noexcept;
     void setClimatePriorityEnabled(bool) noexcept;
@@ -188,7 +413,29 @@ public:
     InventoryManagementMode getNPCInventoryManagementMode() const noexcept;
     void setNPCInventoryManagementMode(InventoryManagementMode mode) noexcept;
     //
-    proto::OutfitSystem save();// can throw save_error
+    // The JSON export. Keeps the v1 layout, with forms as "0x1a2b|Plugin.esp" strings rather than the co-save's plugin
+    // table, so the file stays editable by hand and importable by older releases.
+    proto::OutfitSystem saveForExport();
+    //
+    // Chunked (v3) co-save. Only chunks whose content hash changed since the last save are re-serialized; the
+    // returned views stay valid until the next call.
+    proto::OutfitSystem saveSettings() const;
+    void saveOutfitChunks(std::vector<std::string_view>& out);// can throw save_error
+    std::string_view saveAssignments();                       // can throw save_error
+    void loadChunk(const proto::OutfitSystemChunk& chunk, std::span<const char> serialized);
     //
     void dump() const;
+
+private:
+    struct SerializedChunk {
+        std::uint64_t hash = 0;
+        bool valid = false;
+        std::string blob;
+    };
+    std::array<SerializedChunk, ce_outfitChunkCount> outfitChunkCache;
+    SerializedChunk assignmentsChunkCache;
+
+    static std::size_t outfitChunkIndex(const cobb::istring& name) noexcept;
+    static std::uint64_t hashOutfitChunk(std::span<const Outfit* const> chunk) noexcept;
+    std::uint64_t hashAssignments() const noexcept;
 };
\ No newline at end of file
@@ -0,0 +1,192 @@
+#pragma once
+
+#include <array>
+#include <future>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "RE/Skyrim.h"
+
+// Read-only snapshot of every armor and outfit record in the load order. The forms are read on the main thread once
+// every plugin has handled kDataLoaded; sorting and indexing that copy happens on a worker thread. Armor data is laid out as parallel columns indexed by ArmorCatalog::Index, so a search
+// only walks the columns it filters on. Readers hold a shared_ptr, so rebuilding never invalidates a listing that is
+// still in progress.
+class ArmorCatalog {
+public:
+    using Index = std::uint32_t;
+    using PluginIndex = std::uint16_t;
+    static constexpr PluginIndex kNoPlugin = 0xFFFF;
+
+    enum Flags : std::uint8_t {
+        kPlayable = 1 << 0,
+        kTemplated = 1 << 1,  // enchanted variant generated from a template armor
+        kHasFullName = 1 << 2,// nameless armors are left out of name searches
+        kEnchanted = 1 << 3,
+    };
+
+    struct Plugin {
+        std::string_view name;
+        const RE::TESFile* file;
+        std::uint8_t compileIndex;
+        std::uint16_t lightIndex;// only meaningful for light plugins
+        bool light;
+        bool excluded;// vanilla master; hidden from the mod listings
+        Index armorBegin;// into the per-plugin row arrays, see armorsOf/outfitsOf
+        Index armorCount;
+        Index outfitBegin;
+        Index outfitCount;
+
+        std::uint32_t loadOrderKey() const noexcept {
+            return light ? (0xFEu << 12) | lightIndex : static_cast<std::uint32_t>(compileIndex) << 12;
+        }
+    };
+
+    using PendingBuild = std::shared_future<std::shared_ptr<const ArmorCatalog>>;
+    // Starts a build, unless one is already running; either way returns the build Get will wait for. Form tables
+    // don't change at runtime, so a running build is as good as a new one. Reads the forms on the calling thread, so
+    // call it from the main thread, and not before every plugin has handled kDataLoaded: they still rename armors and
+    // add keywords then.
+    static PendingBuild BuildAsync();
+    // Blocks until the newest build has finished. Starts one (see BuildAsync) if none was started yet.
+    static std::shared_ptr<const ArmorCatalog> Get();
+
+    // Armor columns.
+    std::vector<RE::TESObjectARMO*> forms;
+    std::vector<std::string_view> names;     // full name, falling back to the editor ID or a generated name; copied
+    std::vector<std::string_view> searchKeys;// case-folded full name, empty for nameless armors
+    std::vector<std::string_view> listNames; // names, plus " [FormID]" where one plugin has several armors of that name
+    std::vector<PluginIndex> plugins;
+    std::vector<std::uint32_t> slotMasks;
+    std::vector<std::uint8_t> flags;
+    std::vector<Index> keywordOffsets;// size() + 1 entries into keywordIDs
+    std::vector<RE::FormID> keywordIDs;
+
+    // Outfit columns.
+    std::vector<RE::BGSOutfit*> outfitForms;
+    std::vector<std::string_view> outfitNames;// editor ID, or a generated name
+    std::vector<PluginIndex> outfitPlugins;
+
+    std::vector<Plugin> pluginTable;// plugins that define at least one armor or outfit, in load order
+
+    // Names and list names interned in the game's string table, so listings hand Papyrus existing handles instead of
+    // looking every name up again. Not stored in the cache file; they're interned when a catalog is built or loaded.
+    std::vector<RE::BSFixedString> papyrusNames;
+    std::vector<RE::BSFixedString> papyrusListNames;
+
+    std::size_t size() const noexcept { return forms.size(); }
+    bool has(Index i, Flags flag) const noexcept { return (flags[i] & flag) != 0; }
+    std::span<const RE::FormID> keywords(Index i) const;
+    const Plugin* findPlugin(std::string_view filename) const;
+    const Plugin* findPlugin(const RE::TESFile* file) const;// by compile or light index
+    // A plugin's rows: armors in natural order (equal names by form ID), outfits by editor ID.
+    std::span<const Index> armorsOf(const Plugin& plugin) const;
+    std::span<const Index> outfitsOf(const Plugin& plugin) const;
+    // Non-excluded plugins that define armors (or outfits), sorted by file name.
+    std::span<const PluginIndex> armorMods() const { return m_armorMods; }
+    std::span<const PluginIndex> outfitMods() const { return m_outfitMods; }
+
+    // Fills out with the named armors whose search key contains key, in catalog order. The key must already be
+    // case-folded (see MakeSearchKey); an empty key matches every named armor.
+    void search(std::string_view key, std::vector<Index>& out) const;
+    // Combined armor filter. Every attribute is backed by a bitmap over the rows, so each condition is one pass of
+    // word-wise ANDs.
+    struct Query {
+        std::uint32_t slotsAll = 0; // must occupy every one of these slots
+        std::uint32_t slotsAny = 0; // must occupy at least one of these, if any are given
+        std::uint32_t slotsNone = 0;// must occupy none of these
+        std::uint8_t requiredFlags = 0;
+        std::uint8_t excludedFlags = 0;
+        std::optional<std::vector<PluginIndex>> plugins;// defined by one of these
+        std::vector<RE::FormID> keywordsAll;
+        std::vector<RE::FormID> keywordsAny;
+        std::string name;// search key, as for search()
+    };
+    // Fills out with the rows matching every condition of the query, in catalog order.
+    void query(const Query& query, std::vector<Index>& out) const;
+    // Ranked, typo-tolerant search. Every word of the key has to match some word of a name exactly, as a prefix, as a
+    // substring or within a small edit distance; names starting with the key rank higher. Fills out with at most
+    // limit rows that have all of requiredFlags and none of excludedFlags, best match first.
+    void searchFuzzy(std::string_view key, std::uint8_t requiredFlags, std::uint8_t excludedFlags, std::size_t limit,
+                     std::vector<Index>& out) const;
+
+    static bool IsExcludedPlugin(std::string_view filename);
+    // Built catalogs are cached here, keyed by a hash of the load order and of what the snapshot read from the forms, and
+    // reused while neither changes.
+    static std::string GetCachePath();
+    static std::string MakeSearchKey(std::string_view text);
+
+private:
+    std::string m_strings;// backs every view above except the list names in m_listNameStrings
+    std::string m_listNameStrings;
+    std::unordered_map<std::string_view, PluginIndex> m_pluginsByName;
+    std::array<PluginIndex, 0x100> m_byCompileIndex;
+    std::vector<PluginIndex> m_byLightIndex;// 0x1000 entries
+    std::vector<Index> m_pluginArmors;
+    std::vector<Index> m_pluginOutfits;
+    std::vector<PluginIndex> m_armorMods;
+    std::vector<PluginIndex> m_outfitMods;
+
+    // Inverted index from 32-bit keys to the ascending rows that have them.
+    struct PostingIndex {
+        std::vector<std::uint32_t> keys;// sorted, distinct
+        std::vector<Index> offsets;     // keys.size() + 1 entries into postings
+        std::vector<Index> postings;
+
+        // pairs are (key << 32 | row); they're sorted and deduplicated in place.
+        void build(std::vector<std::uint64_t>& pairs);
+        std::span<const Index> find(std::uint32_t key) const;
+    };
+
+    // Trigram index over the search keys. Keys shorter than a trigram fall back to a linear scan.
+    static constexpr std::size_t kTrigramLength = 3;
+    PostingIndex m_trigramIndex;
+    PostingIndex m_keywordIndex;
+
+    // One bitmap per biped slot and per flag bit, each m_bitmapWords 64-bit words long.
+    std::size_t m_bitmapWords = 0;
+    std::vector<std::uint64_t> m_slotBitmaps;
+    std::vector<std::uint64_t> m_flagBitmaps;
+
+    // What a build reads from the forms, copied on the main thread. Full names are held as BSFixedStrings, which keeps
+    // the game's string alive even if the armor is renamed later.
+    struct Snapshot {
+        struct Armor {
+            RE::TESObjectARMO* form;
+            const RE::TESFile* file;
+            std::uint32_t slotMask;
+            std::uint8_t flags;
+            RE::BSFixedString fullName;
+            std::string fallbackName;// editor ID or a generated name, for armors without a full name
+            Index keywordEnd;        // into keywordIDs; the armor's keywords start where the previous armor's end
+        };
+        struct Outfit {
+            RE::BGSOutfit* form;
+            const RE::TESFile* file;
+            std::string name;
+        };
+        std::vector<Armor> armors;
+        std::vector<RE::FormID> keywordIDs;
+        std::vector<Outfit> outfits;
+    };
+    static Snapshot TakeSnapshot(RE::TESDataHandler* dataHandler);
+    static std::shared_ptr<const ArmorCatalog> Build(Snapshot snapshot);
+    void buildPluginIndex();
+    void buildLookups();
+    void buildListNames(const std::vector<std::string>& collationKeys);
+    void buildTrigramIndex();
+    void buildAttributeIndex();
+    void buildPapyrusNames(const Snapshot& snapshot);
+
+    static std::uint64_t CacheKey(RE::TESDataHandler* dataHandler, const Snapshot& snapshot);
+    static std::shared_ptr<const ArmorCatalog> LoadCache(RE::TESDataHandler* dataHandler, std::uint64_t cacheKey, const Snapshot& snapshot);
+    void writeCache(std::uint64_t cacheKey) const;
+    bool validate() const;
+    // Lists every column that goes into the cache file, in file order; shared by reading and writing.
+    template <class Self, class Archive>
+    static bool Transfer(Self& self, Archive& archive);
+};
@@ -4,19 +4,95 @@
 
 #pragma once
 
-#include <sstream>
+#include <mutex>
+#include <span>
 
 #include <RE/Skyrim.h>
 #include <REL/Relocation.h>
 #include <SKSE/SKSE.h>
 
+#include "outfit.pb.h"
+
 #ifndef FORM_H
 #define FORM_H
 
 #endif //FORM_H
 
 namespace Forms {
-    bool IsFormString(const std::string &str);
+    bool IsFormString(std::string_view str);
     std::string GetFormString(RE::TESForm* obj);
-    RE::TESForm* ParseFormString(const std::string &objString);
+    RE::TESForm* ParseFormString(std::string_view objString);
+
+    // Caches "0x1a2b|Plugin.esp" strings by form ID. The strings live in a block pool that is only released when the
+    // load order the cache was built against changes (or on invalidate()), so returned views stay valid until then.
+    class FormStringCache {
+    public:
+        static FormStringCache& GetSingleton() {
+            static FormStringCache singleton;
+            return singleton;
+        }
+
+        std::string_view format(RE::TESForm* form);
+        // Formats every form into out (resized to forms.size()); null or unresolvable forms map to "0".
+        void formatAll(std::span<RE::TESForm* const> forms, std::vector<std::string_view>& out);
+        void invalidate();
+
+    private:
+        FormStringCache() = default;
+
+        static constexpr std::size_t kBlockSize = 64 * 1024;
+
+        std::string_view formatLocked(RE::TESForm* form);
+        std::string_view intern(std::string_view text);
+        void checkLoadOrderLocked();
+
+        std::mutex m_lock;
+        std::uint64_t m_loadOrderStamp = 0;
+        std::unordered_map<std::uint64_t, std::string_view> m_strings;// form ID, plus form type for temporary forms
+        std::vector<std::unique_ptr<char[]>> m_blocks;
+        std::size_t m_blockUsed = kBlockSize;
+        fmt::memory_buffer m_scratch;
+    };
+
+    // Builds the plugin table of a v2 save record while its forms are being written.
+    class FormReferenceWriter {
+    public:
+        bool write(RE::TESForm* form, proto::FormReference* out);// false if the form can't be referenced
+        void store(google::protobuf::RepeatedPtrField<proto::PluginEntry>* out) const;
+
+    private:
+        std::unordered_map<const RE::TESFile*, std::uint32_t> m_indices;
+        std::vector<const RE::TESFile*> m_files;
+    };
+
+    // Per-load form resolution state. Plugin lookups are memoized by name, so resolving thousands of forms from the
+    // same handful of plugins only asks TESDataHandler once per plugin. Optionally bound to the plugin table of a v2
+    // save record.
+    class ResolutionContext {
+    public:
+        ResolutionContext() = default;
+        explicit ResolutionContext(const google::protobuf::RepeatedPtrField<proto::PluginEntry>& plugins);
+
+        RE::TESForm* parse(std::string_view formString);           // "0x1a2b|Plugin.esp" (v1)
+        RE::TESForm* resolve(const proto::FormReference& ref) const;// plugin table reference (v2)
+
+        // Appends a plugin to the bound table and returns its index, for tables that don't come from a proto.
+        std::uint32_t bindPlugin(std::string_view name, bool isLight);
+        RE::TESForm* resolve(std::uint32_t plugin, std::uint32_t localID) const;
+
+    private:
+        struct ResolvedPlugin {
+            std::uint32_t prefix = 0;
+            std::uint32_t localMask = 0;// 0 when the plugin isn't loaded
+        };
+        struct NameHash {
+            using is_transparent = void;
+            std::size_t operator()(std::string_view name) const noexcept { return std::hash<std::string_view>{}(name); }
+        };
+
+        const ResolvedPlugin& lookupPlugin(std::string_view name);
+
+        std::unordered_map<std::string, ResolvedPlugin, NameHash, std::equal_to<>> m_pluginsByName;
+        std::vector<ResolvedPlugin> m_pluginTable;
+    };
 }
\ No newline at end of file
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+
+#include "Forms.h"
+
+struct Outfit;
+class ArmorAddonOverrideService;
+
+// Optional outfit library shared by every save, stored next to the INI as SkyrimOutfitEquipmentSystemNG.library.
+// The file is memory-mapped once per game session and read in place; saves only keep the outfits that differ from
+// it (plus the names of library outfits deleted in that save), and list the rest straight from the mapping.
+//
+// Layout (all integers little-endian, offsets from the start of the file):
+//   FileHeader
+//   PluginRecord[pluginCount]
+//   OutfitRecord[outfitCount]   sorted case-insensitively by name
+//   ArmorRecord[armorCount]
+//   string data                 plugin and outfit names, not null-terminated
+class GlobalOutfitLibrary {
+public:
+    static constexpr std::uint32_t kMagic = 'SOEL';
+    static constexpr std::uint32_t kVersion = 1;
+
+    struct FileHeader {
+        std::uint32_t magic;
+        std::uint32_t version;
+        std::uint32_t fileSize;
+        std::uint32_t pluginCount;
+        std::uint32_t pluginsOffset;
+        std::uint32_t outfitCount;
+        std::uint32_t outfitsOffset;
+        std::uint32_t armorCount;
+        std::uint32_t armorsOffset;
+        std::uint32_t stringsOffset;
+        std::uint32_t stringsSize;
+    };
+    struct PluginRecord {
+        std::uint32_t nameOffset;// into string data
+        std::uint16_t nameLength;
+        std::uint8_t isLight;
+        std::uint8_t padding;
+    };
+    struct OutfitRecord {
+        enum Flags : std::uint8_t {
+            kFavorite = 1 << 0,
+        };
+        std::uint32_t nameOffset;// into string data
+        std::uint16_t nameLength;
+        std::uint8_t flags;
+        std::uint8_t padding;
+        std::uint32_t firstArmor;
+        std::uint32_t armorCount;
+    };
+    struct ArmorRecord {
+        std::uint32_t plugin;// index into the plugin records
+        std::uint32_t localID;
+    };
+
+    static GlobalOutfitLibrary& GetSingleton() {
+        static GlobalOutfitLibrary singleton;
+        return singleton;
+    }
+
+    GlobalOutfitLibrary(const GlobalOutfitLibrary&) = delete;
+    GlobalOutfitLibrary(GlobalOutfitLibrary&&) = delete;
+    GlobalOutfitLibrary& operator=(const GlobalOutfitLibrary&) = delete;
+    GlobalOutfitLibrary& operator=(GlobalOutfitLibrary&&) = delete;
+
+    static std::string GetPath();
+    static std::string GetPendingPath();// exports land here and replace the library at the start of the next session
+
+    // Maps the library on first call (if enabled in the INI); later calls are no-ops. Needs the data handler.
+    bool Open();
+    bool IsOpen() const noexcept { return m_header != nullptr; }
+
+    std::size_t size() const noexcept { return IsOpen() ? m_header->outfitCount : 0; }
+    std::string_view name(std::size_t index) const;
+    bool isFavorite(std::size_t index) const;
+    std::optional<std::size_t> find(std::string_view name) const;
+
+    void readArmors(std::size_t index, std::unordered_set<RE::TESObjectARMO*>& out) const;
+    bool matches(std::size_t index, const Outfit& outfit) const;// same armors as the library copy
+
+    // Serializes every outfit of the service into the on-disk layout.
+    static std::string Build(ArmorAddonOverrideService& service);
+
+private:
+    GlobalOutfitLibrary() = default;
+    ~GlobalOutfitLibrary();
+
+    bool m_opened = false;
+    void* m_file = nullptr;
+    void* m_mapping = nullptr;
+    const std::byte* m_view = nullptr;
+    const FileHeader* m_header = nullptr;
+    const OutfitRecord* m_outfits = nullptr;
+    const ArmorRecord* m_armors = nullptr;
+    const char* m_strings = nullptr;
+    bool m_sorted = false;// libraries written before names were compared with Unicode folding may be out of order
+    Forms::ResolutionContext m_forms;
+
+    bool Validate(std::size_t fileSize);
+    void Close();
+};
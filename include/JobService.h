@@ -0,0 +1,87 @@
+//
+// Runs long native operations on worker threads and lets Papyrus follow them by job ID.
+//
+
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "RE/Skyrim.h"
+
+class JobService {
+public:
+    using JobID = std::int32_t;
+    static constexpr JobID kNoJob = 0;
+
+    // Values are returned as-is by the GetJobStatus native.
+    enum class Status : std::int32_t {
+        kUnknown = 0,// never started, or finished long enough ago to have been forgotten
+        kRunning = 1,
+        kSucceeded = 2,
+        kFailed = 3,
+    };
+
+    // Sent through SKSE's mod event source when a job finishes: strArg is the job's kind, numArg its ID.
+    static constexpr const char* kFinishedEvent = "SkyOutEquSys_JobFinished";
+
+    class Job {
+    public:
+        JobID id() const noexcept { return m_id; }
+        const std::string& kind() const noexcept { return m_kind; }
+
+        // Progress is reported as steps done out of a total, either of which may change while the job runs.
+        void setTotal(std::uint32_t total) noexcept { m_total = total; }
+        void advance(std::uint32_t steps = 1) noexcept { m_done += steps; }
+
+        // Every job has to be finished exactly once, from any thread; later calls are ignored. result is handed to
+        // Papyrus by GetJobResult, e.g. how many outfits an import added.
+        void finish(bool succeeded, std::int32_t result = 0);
+
+    private:
+        friend class JobService;
+
+        JobID m_id = kNoJob;
+        std::string m_kind;
+        std::atomic<Status> m_status{Status::kRunning};
+        std::atomic<std::uint32_t> m_done{0};
+        std::atomic<std::uint32_t> m_total{0};
+        std::atomic<std::int32_t> m_result{0};
+    };
+    // Runs on its own worker thread. Work that has to touch game or service state can queue a task for the main
+    // thread and finish the job from there. A job whose work throws is failed.
+    using Work = std::function<void(const std::shared_ptr<Job>&)>;
+
+    static JobService& GetSingleton() {
+        static JobService singleton;
+        return singleton;
+    }
+
+    JobService(const JobService&) = delete;
+    JobService(JobService&&) = delete;
+    JobService& operator=(const JobService&) = delete;
+    JobService& operator=(JobService&&) = delete;
+
+    std::shared_ptr<Job> Start(std::string kind, Work work);
+
+    Status GetStatus(JobID id) const;
+    float GetProgress(JobID id) const;// 0 to 1; 1 once finished
+    std::int32_t GetResult(JobID id) const;
+
+private:
+    JobService() = default;
+    ~JobService() = default;
+
+    // Only this many jobs are remembered; older ones read as kUnknown.
+    static constexpr std::size_t kMaxJobs = 32;
+
+    mutable std::mutex m_lock;
+    std::deque<std::shared_ptr<Job>> m_jobs;
+    JobID m_nextID = 1;
+
+    std::shared_ptr<Job> Find(JobID id) const;
+};
@@ -0,0 +1,20 @@
+//
+// Call counts and latencies of the Papyrus natives, recorded by their LogExit guards.
+//
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <string_view>
+
+namespace NativeProfiler {
+    // Adds one call of the named native to the calling thread's counters, without taking a lock once the thread has
+    // seen the name. Names are looked up by address, so they should be string literals.
+    void Record(std::string_view name, std::chrono::steady_clock::duration elapsed) noexcept;
+    // Writes every native's call count, total, mean and max latency and latency histogram to the plugin log (and the
+    // console, if it's open), the most total time first. Returns how many natives were listed.
+    std::size_t Dump();
+    // Calls that are in progress while this runs may still be counted afterwards.
+    void Reset();
+}
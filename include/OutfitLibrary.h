@@ -0,0 +1,43 @@
+#pragma once
+
+#include <string>
+
+#include "outfit.pb.h"
+
+struct Outfit;
+class ArmorAddonOverrideService;
+
+// Directory-based outfit library: Data\SKSE\Plugins\OutfitEquipmentSystemNGLibrary\ holds an index of every
+// outfit's name, favorite flag and slot mask, plus one small file per outfit. Importing only reads the index; the
+// outfits it adds stay "pending" until something asks for their contents or the game is saved, which writes every
+// outfit in full (see ArmorAddonOverrideService::saveOutfitChunks).
+namespace OutfitLibrary {
+    constexpr std::uint32_t kIndexVersion = 1;
+
+    std::string GetDirectory();
+    std::string GetIndexPath();
+
+    // File name (relative to the library directory) that an outfit of this name is stored under. Derived from the
+    // case-folded name, so re-exporting an outfit keeps its file name.
+    std::string GetOutfitFileName(const std::string& name);
+
+    // Reads and resolves a pending outfit's armors. The outfit stops being pending either way, so a missing or corrupt
+    // file is only tried once; on failure the outfit is left empty.
+    bool LoadOutfitBody(Outfit& outfit);
+
+    // Reads the library's index. Only touches the file system, so it can run on any thread.
+    bool ReadIndex(proto::OutfitLibraryIndex& index);
+    // Adds every outfit listed in the index that the service doesn't already have, as a pending outfit. Returns the
+    // number of outfits added.
+    std::int32_t ImportIndex(ArmorAddonOverrideService& service, const proto::OutfitLibraryIndex& index);
+
+    struct ExportData {
+        proto::OutfitLibraryIndex index;
+        std::vector<std::pair<std::string, std::string>> files;// file name, serialized OutfitSystemChunk
+    };
+
+    // Serializes every outfit of the service (reading pending ones first). Must run where form lookups are safe; the
+    // result can be written from any thread with WriteExport.
+    ExportData BuildExport(ArmorAddonOverrideService& service);
+    bool WriteExport(const ExportData& data, std::string& error);
+}
@@ -39,7 +39,7 @@ namespace OutfitSystem {
                     auto& outfitAssignment = armorAddonOverrideService.actorOutfitAssignments.at(actor);
 
                     if (!isPlayerCharacter && !outfitAssignment.currentOutfitName.empty() && armorAddonOverrideService.outfits.contains(outfitAssignment.currentOutfitName)) {
-                        auto currentOutfitArmors = armorAddonOverrideService.outfits.at(outfitAssignment.currentOutfitName).m_armors;
+                        auto currentOutfitArmors = armorAddonOverrideService.getOutfit(outfitAssignment.currentOutfitName.c_str()).m_armors;
 
                         // When in an exception state, i.e love scene, let that system equip/unquip whatever it wants.
                         bool inExceptionState = false;
@@ -0,0 +1,70 @@
+//
+// Moves ExportSettings/ImportSettings off the Papyrus thread. Transfers run as jobs (see JobService), one at a time.
+//
+
+#pragma once
+
+#include <atomic>
+#include <string>
+
+#include "RE/Skyrim.h"
+
+#include "JobService.h"
+#include "OutfitLibrary.h"
+#include "outfit.pb.h"
+
+class SettingsTransferService {
+public:
+    // Values are returned as-is by the GetSettingsTransferStatus native.
+    enum class Status : std::int32_t {
+        kIdle = 0,
+        kExporting = 1,
+        kImporting = 2,
+        kSucceeded = 3,
+        kFailed = 4,
+    };
+
+    static SettingsTransferService& GetSingleton() {
+        static SettingsTransferService singleton;
+        return singleton;
+    }
+
+    SettingsTransferService(const SettingsTransferService&) = delete;
+    SettingsTransferService(SettingsTransferService&&) = delete;
+    SettingsTransferService& operator=(const SettingsTransferService&) = delete;
+    SettingsTransferService& operator=(SettingsTransferService&&) = delete;
+
+    static std::string GetConfigPath();
+
+    // These return the transfer's job, or JobService::kNoJob without starting anything if a transfer is already
+    // running.
+    JobService::JobID StartExport(proto::OutfitSystem snapshot);
+    JobService::JobID StartImport();
+    JobService::JobID StartLibraryExport(OutfitLibrary::ExportData data);
+    JobService::JobID StartGlobalLibraryExport(std::string contents);
+    // The job's result is how many outfits were added.
+    JobService::JobID StartLibraryImport();
+
+    Status GetStatus() const noexcept { return status.load(); }
+    JobService::JobID GetJob() const noexcept { return job.load(); }// the latest transfer's
+    bool IsBusy() const noexcept;
+
+private:
+    SettingsTransferService() = default;
+    ~SettingsTransferService() = default;
+
+    using JobPtr = std::shared_ptr<JobService::Job>;
+
+    std::atomic<Status> status{Status::kIdle};
+    std::atomic<JobService::JobID> job{JobService::kNoJob};
+
+    bool TryBegin(Status running) noexcept;
+    JobService::JobID Run(const char* kind, JobService::Work work);
+    void Finish(const JobPtr& job, bool succeeded, std::string message, std::int32_t result = 0);
+
+    void ExportThreadFunc(const JobPtr& job, proto::OutfitSystem snapshot, std::string outputFile);
+    void ImportThreadFunc(const JobPtr& job, std::string inputFile);
+    void LibraryExportThreadFunc(const JobPtr& job, OutfitLibrary::ExportData data);
+    void GlobalLibraryExportThreadFunc(const JobPtr& job, std::string contents);
+    void LibraryImportThreadFunc(const JobPtr& job);
+};
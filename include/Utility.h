@@ -16,6 +16,7 @@ namespace SettingsDefaults {
     static constexpr int32_t MenuPaginationCount = 1000;
     static constexpr int32_t PollingMS = 2000;
     static constexpr bool AllowExternalEquipment = false;
+    static constexpr bool UseGlobalLibrary = false;
 }
 
 namespace UserTextInputJSON {
@@ -40,6 +41,7 @@ public:
     static int32_t MenuPaginationCount();
     static int32_t PollingMSInterval();
     static bool AllowExternalEquipment();
+    static bool UseGlobalLibrary();
 };
 
 namespace ProtoUtils {
@@ -2,23 +2,32 @@
 #include <string>
 
 namespace cobb {
+   namespace utf8 {
+      int compare_folded(const char*, const char*, size_t); // see utf8string.h
+   }
    struct char_traits_insensitive : public std::char_traits<char> {
+      // Single bytes can only be folded as ASCII; whole strings are compared with Unicode case folding.
+      inline static char fold(char c) {
+         return (c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c;
+      }
       inline static bool eq(char c1, char c2) {
-         return tolower(c1) == tolower(c2);
+         return fold(c1) == fold(c2);
       }
       inline static bool ne(char c1, char c2) {
-         return tolower(c1) != tolower(c2);
+         return fold(c1) != fold(c2);
       }
       inline static bool lt(char c1, char c2) {
-         return tolower(c1) <  tolower(c2);
+         return (unsigned char)fold(c1) < (unsigned char)fold(c2);
       }
       inline static int compare(const char* s1, const char* s2, size_t n) {
-         return _memicmp(s1, s2, n);
+         return utf8::compare_folded(s1, s2, n);
       }
       inline static const char* find(const char* s, int n, char a) {
-         while (n-- > 0 && tolower(*s) != tolower(a))
-            ++s;
-         return s;
+         for (; n > 0; --n, ++s) {
+            if (fold(*s) == fold(a))
+               return s;
+         }
+         return nullptr;
       }
    };
    typedef std::basic_string<char, char_traits_insensitive> istring; // compares case-insensitively but stores the string as it was received
@@ -1,8 +1,21 @@
 #pragma once
 #include "strings.h"
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
 
 namespace cobb {
    namespace utf8 {
+      // Positive if a sorts before b, negative if after, zero if their natural keys are equal.
       int32_t naturalcompare(const std::string& a, const std::string& b);
+
+      // Writes a key whose byte order (memcmp) matches naturalcompare's ascending order: folded text, with each run
+      // of digits replaced by a marker, its significant digit count and the digits.
+      void naturalkey(std::string_view text, std::string& out);
+
+      // Permutation that puts texts in natural order, keeping texts with equal keys in their original order. Each
+      // text is keyed once; large inputs are keyed and sorted in parallel.
+      std::vector<std::uint32_t> naturalorder(std::span<const std::string_view> texts, bool descending);
    }
 };
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 #include "strings.h"
 #include <string> 
+#include <string_view>
 
 using namespace std;
 
@@ -17,5 +18,10 @@ namespace cobb {
       unicodechar get(const std::string&, const std::string::iterator&);
       unicodechar get(const std::string&, const std::string::const_iterator&);
       rawchar     get_raw(const std::string&, const std::string::iterator&);
+
+      unicodechar fold(unicodechar); // simple case folding: always one code point to one code point
+      void        fold(std::string_view, std::string& out); // appends the folded text; ASCII runs go 16 bytes at a time
+      int         compare_folded(const char*, const char*, size_t); // case-insensitive compare of the first n bytes of each
+      size_t      hash_folded(const char*, size_t); // equal for any two strings that compare_folded considers equal
    }
 };
\ No newline at end of file
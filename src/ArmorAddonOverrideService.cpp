@@ -1,9 +1,11 @@
 #include "ArmorAddonOverrideService.h"
 
-#include <google/protobuf/util/json_util.h>
-
 #include "Forms.h"
+#include "GlobalOutfitLibrary.h"
+#include "OutfitLibrary.h"
 #include "OutfitSystemCacheService.h"
+#include "cobb/utf8naturalsort.h"
+#include "cobb/utf8string.h"
 
 #ifndef SKYRIMOUTFITEQUIPMENTSYSTEMNG_INCLUDE_RE_REAUGMENTS_H
 #define SKYRIMOUTFITEQUIPMENTSYSTEMNG_INCLUDE_RE_REAUGMENTS_H
@@ -19,15 +21,87 @@ void _assertRead(bool result, const char* err) {
         throw ArmorAddonOverrideService::load_error(err);
 }
 
-Outfit::Outfit(const proto::Outfit& proto, const SKSE::SerializationInterface* intfc) {
+Outfit::Outfit(const proto::Outfit& proto, Forms::ResolutionContext& forms) {
     m_name = proto.name();
+    m_armors.reserve(proto.armors_size() + proto.armor_refs_size());
+    // v1
     for (const auto& formID : proto.armors()) {
-        RE::TESObjectARMO* armor = skyrim_cast<RE::TESObjectARMO*>(Forms::ParseFormString(formID));
-        m_armors.insert(armor);
+        RE::TESObjectARMO* armor = skyrim_cast<RE::TESObjectARMO*>(forms.parse(formID));
+        if (armor)
+            m_armors.insert(armor);
+    }
+    // v2
+    for (const auto& ref : proto.armor_refs()) {
+        RE::TESObjectARMO* armor = skyrim_cast<RE::TESObjectARMO*>(forms.resolve(ref));
+        if (armor)
+            m_armors.insert(armor);
     }
     m_favorited = proto.is_favorite();
 }
 
+std::size_t OutfitName::Hash::operator()(std::string_view name) const noexcept {
+    return cobb::utf8::hash_folded(name.data(), name.size());
+}
+
+bool OutfitMap::SortedLess::operator()(const SortedEntry& a, const SortedEntry& b) const noexcept {
+    // Names like "Outfit 1" and "outfit 01" share a collation key; their exact spelling breaks the tie.
+    if (const int order = a.key.compare(b.key); order != 0)
+        return order < 0;
+    return OutfitName::View(a.outfit->first) < OutfitName::View(b.outfit->first);
+}
+
+OutfitMap& OutfitMap::operator=(const OutfitMap& other) {
+    if (this != &other) {
+        m_map = other.m_map;
+        rebuildOrder();
+    }
+    return *this;
+}
+
+OutfitMap::insert_return_type OutfitMap::insert(node_type&& node) {
+    auto result = m_map.insert(std::move(node));
+    if (result.inserted)
+        addToOrder(*result.position);
+    return result;
+}
+
+void OutfitMap::setFavorite(value_type& outfit, bool favorite) {
+    if (outfit.second.m_favorited == favorite)
+        return;
+    outfit.second.m_favorited = favorite;
+    outfit.second.markChanged();
+    SortedEntry entry{{}, &outfit};
+    cobb::utf8::naturalkey(OutfitName::View(outfit.first), entry.key);
+    if (favorite)
+        m_favorites.insert(std::move(entry));
+    else
+        m_favorites.erase(entry);
+}
+
+void OutfitMap::addToOrder(value_type& outfit) {
+    outfit.second.m_papyrusName = outfit.second.m_name.c_str();
+    SortedEntry entry{{}, &outfit};
+    cobb::utf8::naturalkey(OutfitName::View(outfit.first), entry.key);
+    if (outfit.second.m_favorited)
+        m_favorites.insert(entry);
+    m_sorted.insert(std::move(entry));
+}
+
+void OutfitMap::removeFromOrder(value_type& outfit) {
+    SortedEntry entry{{}, &outfit};
+    cobb::utf8::naturalkey(OutfitName::View(outfit.first), entry.key);
+    m_favorites.erase(entry);
+    m_sorted.erase(entry);
+    outfit.second.m_papyrusName = RE::BSFixedString();
+}
+
+void OutfitMap::rebuildOrder() {
+    m_sorted.clear();
+    m_favorites.clear();
+    for (auto& outfit : m_map)
+        addToOrder(outfit);
+}
+
 bool Outfit::conflictsWith(RE::TESObjectARMO* test) const {
     if (!test)
         return false;
@@ -53,25 +127,101 @@ bool Outfit::hasShield() const {
     return false;
 };
 
-proto::Outfit Outfit::save() const {
+proto::Outfit Outfit::save(Forms::FormReferenceWriter& refs) const {
     proto::Outfit out;
     out.set_name(m_name);
+    out.set_is_favorite(m_favorited);
+    // Always the full outfit, even for one that came from the outfit library: a later export can replace the
+    // library's files, so a save must not depend on them. Callers read pending outfits first (see materialize).
+    out.mutable_armor_refs()->Reserve(static_cast<int>(m_armors.size()));
+    for (const auto& armor : m_armors) {
+        if (armor && !refs.write(armor, out.add_armor_refs()))
+            out.mutable_armor_refs()->RemoveLast();
+    }
+    return out;
+}
+
+proto::Outfit Outfit::saveForExport() const {
+    proto::Outfit out;
+    out.set_name(m_name);
+    out.set_is_favorite(m_favorited);
     for (const auto& armor : m_armors) {
         if (armor)
             out.add_armors(Forms::GetFormString(armor));
     }
-    out.set_is_favorite(m_favorited);
     return out;
 }
 
+namespace {
+    ArmorAddonOverrideService::ActorOutfitAssignments readAssignments(const proto::ActorOutfitAssignment& assnData) {
+        ArmorAddonOverrideService::ActorOutfitAssignments assignments;
+        assignments.currentOutfitName =
+            cobb::istring(assnData.current_outfit_name().data(), assnData.current_outfit_name().size());
+        for (const auto& locOutfitData : assnData.location_based_outfits()) {
+            assignments.locationOutfits.emplace(
+                static_cast<LocationType>(locOutfitData.first),
+                cobb::istring(locOutfitData.second.data(),
+                locOutfitData.second.size())
+            );
+        }
+        return assignments;
+    }
+
+    void writeAssignments(const ArmorAddonOverrideService::ActorOutfitAssignments& assignments, proto::ActorOutfitAssignment* assnOut) {
+        assnOut->set_current_outfit_name(assignments.currentOutfitName.data(), assignments.currentOutfitName.size());
+        for (const auto& locationBasedOutfit : assignments.locationOutfits) {
+            assnOut->mutable_location_based_outfits()
+                ->insert({
+                    static_cast<std::uint32_t>(locationBasedOutfit.first),
+                    std::string(locationBasedOutfit.second.data(), locationBasedOutfit.second.size())
+                });
+        }
+    }
+
+    // FNV-1a, used for the content hashes of co-save chunks.
+    constexpr std::uint64_t kHashBasis = 0xcbf29ce484222325ull;
+    constexpr std::uint64_t kHashPrime = 0x100000001b3ull;
+
+    std::uint64_t hashBytes(std::uint64_t hash, const void* data, std::size_t size) noexcept {
+        auto bytes = static_cast<const std::uint8_t*>(data);
+        for (std::size_t i = 0; i < size; ++i) {
+            hash = (hash ^ bytes[i]) * kHashPrime;
+        }
+        return hash;
+    }
+
+    template <typename T>
+    std::uint64_t hashValue(std::uint64_t hash, const T& value) noexcept {
+        static_assert(std::is_trivially_copyable_v<T>);
+        return hashBytes(hash, &value, sizeof(T));
+    }
+
+    std::uint64_t hashString(std::uint64_t hash, std::string_view value) noexcept {
+        hash = hashValue(hash, value.size());
+        return hashBytes(hash, value.data(), value.size());
+    }
+
+    // Armor sets are unordered, so their members are combined with a commutative sum of mixed form IDs.
+    std::uint64_t mixFormID(RE::FormID formID) noexcept {
+        std::uint64_t x = formID;
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdull;
+        x ^= x >> 33;
+        return x;
+    }
+
+    void serializeChunk(const proto::OutfitSystemChunk& chunk, std::string& out) {
+        out.clear();
+        if (!chunk.SerializeToString(&out))
+            throw ArmorAddonOverrideService::save_error("Failed to serialize co-save chunk.");
+    }
+}
+
 ArmorAddonOverrideService::ArmorAddonOverrideService(const proto::OutfitSystem& data, const SKSE::SerializationInterface* intfc) {
     try {
-        std::string protoData;
-        google::protobuf::util::JsonPrintOptions options;
-        options.add_whitespace = true;
-        auto status = google::protobuf::util::MessageToJsonString(data, &protoData, options);
-
-        EXTRALOG(info, "Reading the following stored SKSE data:\n {}", protoData);
+        if (Settings::ExtraLoggingEnabled()) {
+            EXTRALOG(info, "Reading the following stored SKSE data:\n {}", ProtoUtils::readMessageAsJSON(data));
+        }
 
         // Extract data from the protobuf struct.
         enabled = data.enabled();
@@ -79,34 +229,29 @@ ArmorAddonOverrideService::ArmorAddonOverrideService(const proto::OutfitSystem&
         climatePriorityEnabled = data.climate_priority_enabled();
         playerInventoryManagementMode = static_cast<InventoryManagementMode>(data.player_inventory_management_mode());
         npcInventoryManagementMode = static_cast<InventoryManagementMode>(data.npc_inventory_management_mode());
+        for (const auto& hidden : data.hidden_library_outfits())
+            hiddenLibraryOutfits.emplace(hidden.data(), hidden.size());
         std::map<RE::Actor*, ActorOutfitAssignments> actorOutfitAssignmentsLocal;
+        Forms::ResolutionContext forms(data.plugins());
 
+        // v1
         for (const auto& actorAssn : data.actor_outfit_assignments()) {
             // Lookup the actor
-            std::uint64_t handle;
-            std::string actorRefFormString = actorAssn.first;
-
-            RE::Actor* actor = skyrim_cast<RE::Actor*>(Forms::ParseFormString(actorRefFormString));
-
-            ActorOutfitAssignments assignments;
-            assignments.currentOutfitName =
-                cobb::istring(actorAssn.second.current_outfit_name().data(), actorAssn.second.current_outfit_name().size());
-            for (const auto& locOutfitData : actorAssn.second.location_based_outfits()) {
-                assignments.locationOutfits.emplace(
-                    static_cast<LocationType>(locOutfitData.first),
-                    cobb::istring(locOutfitData.second.data(),
-                    locOutfitData.second.size())
-                );
-            }
+            RE::Actor* actor = skyrim_cast<RE::Actor*>(forms.parse(actorAssn.first));
+            actorOutfitAssignmentsLocal[actor] = readAssignments(actorAssn.second);
+        }
 
-            actorOutfitAssignmentsLocal[actor] = assignments;
+        // v2
+        for (const auto& actorAssn : data.actor_assignments()) {
+            RE::Actor* actor = skyrim_cast<RE::Actor*>(forms.resolve(actorAssn.actor()));
+            actorOutfitAssignmentsLocal[actor] = readAssignments(actorAssn);
         }
 
         actorOutfitAssignments = actorOutfitAssignmentsLocal;
         for (const auto& outfitData : data.outfits()) {
             outfits.emplace(std::piecewise_construct,
                             std::forward_as_tuple(cobb::istring(outfitData.name().data(), outfitData.name().size())),
-                            std::forward_as_tuple(outfitData, intfc));
+                            std::forward_as_tuple(outfitData, forms));
         }
     }
     catch (const std::exception &e) {
@@ -123,13 +268,50 @@ void ArmorAddonOverrideService::_validateNameOrThrow(const char* outfitName) {
 }
 //
 Outfit& ArmorAddonOverrideService::getOutfit(const char* name) {
-    return outfits.at(name);
+    return materialize(outfits.at(name));
 }
 Outfit& ArmorAddonOverrideService::getOrCreateOutfit(const char* name) {
     _validateNameOrThrow(name);
     auto created = outfits.emplace(name, name);
-    return created.first->second;
+    return materialize(created.first->second);
+}
+Outfit& ArmorAddonOverrideService::materialize(Outfit& outfit) {
+    if (!outfit.m_libraryFile.empty()) {
+        OutfitLibrary::LoadOutfitBody(outfit);
+    } else if (outfit.m_globalLibraryPending) {
+        auto& library = GlobalOutfitLibrary::GetSingleton();
+        if (auto index = library.find(outfit.m_name))
+            library.readArmors(*index, outfit.m_armors);
+        outfit.m_globalLibraryPending = false;
+    }
+    return outfit;
 }
+
+void ArmorAddonOverrideService::attachGlobalLibrary() {
+    auto& library = GlobalOutfitLibrary::GetSingleton();
+    if (!library.Open())
+        return;
+    for (std::size_t i = 0; i < library.size(); ++i) {
+        const auto name = library.name(i);
+        cobb::istring key(name.data(), name.size());
+        if (hiddenLibraryOutfits.contains(key))
+            continue;
+        auto [it, inserted] = outfits.try_emplace(key, std::string(name).c_str());
+        auto& outfit = it->second;
+        if (inserted) {
+            outfits.setFavorite(*it, library.isFavorite(i));
+            outfit.m_fromGlobalLibrary = true;
+            outfit.m_globalLibraryPending = true;
+            outfit.m_globalLibraryCopy = true;
+        } else if (!outfit.isPending() && library.matches(i, outfit)) {
+            // Saves from before the library was set up carry full copies; stop storing them. This is the only
+            // comparison against the library; from here on changes clear the flag (see Outfit::markChanged).
+            outfit.m_fromGlobalLibrary = true;
+            outfit.m_globalLibraryCopy = outfit.m_favorited == library.isFavorite(i);
+        }
+    }
+}
+
 //
 void ArmorAddonOverrideService::addOutfit(const char* name) {
     _validateNameOrThrow(name);
@@ -138,7 +320,8 @@ void ArmorAddonOverrideService::addOutfit(const char* name) {
 
 void ArmorAddonOverrideService::addOutfit(const char* name, std::vector<RE::TESObjectARMO*> armors) {
     _validateNameOrThrow(name);
-    auto& created = outfits.emplace(name, name).first->second;
+    auto& created = materialize(outfits.emplace(name, name).first->second);
+    created.markChanged();
     for (auto it = armors.begin(); it != armors.end(); ++it) {
         auto armor = *it;
         if (armor)
@@ -146,12 +329,22 @@ void ArmorAddonOverrideService::addOutfit(const char* name, std::vector<RE::TESO
     }
 }
 
+void ArmorAddonOverrideService::overwriteOutfit(const char* name, std::span<RE::TESObjectARMO* const> armors) {
+    auto& outfit = getOrCreateOutfit(name);
+    outfit.m_armors.clear();
+    outfit.markChanged();
+    for (auto* armor : armors) {
+        if (armor)
+            outfit.m_armors.insert(armor);
+    }
+}
+
 Outfit& ArmorAddonOverrideService::currentOutfit(RE::Actor* target) {
     if (!actorOutfitAssignments.contains(target)) return g_noOutfit;
     if (actorOutfitAssignments.at(target).currentOutfitName == g_noOutfitName) return g_noOutfit;
     auto outfit = outfits.find(actorOutfitAssignments.at(target).currentOutfitName);
     if (outfit == outfits.end()) return g_noOutfit;
-    return outfit->second;
+    return materialize(outfit->second);
 }
 
 bool ArmorAddonOverrideService::hasOutfit(const char* name) const {
@@ -159,6 +352,8 @@ bool ArmorAddonOverrideService::hasOutfit(const char* name) const {
 }
 
 void ArmorAddonOverrideService::deleteOutfit(const char* name) {
+    if (auto outfit = outfits.find(name); outfit != outfits.end() && outfit->second.m_fromGlobalLibrary)
+        hiddenLibraryOutfits.insert(outfit->first);
     outfits.erase(name);
     for (auto& assn : actorOutfitAssignments) {
         if (assn.second.currentOutfitName == name)
@@ -176,7 +371,7 @@ void ArmorAddonOverrideService::deleteOutfit(const char* name) {
 void ArmorAddonOverrideService::setFavorite(const char* name, bool favorite) {
     auto outfit = outfits.find(name);
     if (outfit != outfits.end())
-        outfit->second.m_favorited = favorite;
+        outfits.setFavorite(*outfit, favorite);
 }
 
 void ArmorAddonOverrideService::modifyOutfit(const char* name,
@@ -185,6 +380,7 @@ void ArmorAddonOverrideService::modifyOutfit(const char* name,
                                              bool createIfMissing) {
     try {
         Outfit& target = getOutfit(name);
+        target.markChanged();
         for (auto it = add.begin(); it != add.end(); ++it) {
             auto armor = *it;
             if (armor)
@@ -207,6 +403,13 @@ void ArmorAddonOverrideService::renameOutfit(const char* oldName, const char* ne
     if (outfits.contains(newName)) throw name_conflict("");
     auto outfitNode = outfits.extract(oldName);
     if (outfitNode.empty()) throw std::out_of_range("");
+    if (outfitNode.mapped().m_fromGlobalLibrary) {
+        // The renamed outfit becomes a local one; the library's copy stays hidden under the old name.
+        materialize(outfitNode.mapped());
+        outfitNode.mapped().m_fromGlobalLibrary = false;
+        outfitNode.mapped().markChanged();
+        hiddenLibraryOutfits.insert(outfitNode.key());
+    }
     outfitNode.key() = newName;
     outfitNode.mapped().m_name = newName;
     outfits.insert(std::move(outfitNode));
@@ -309,82 +512,238 @@ std::optional<cobb::istring> ArmorAddonOverrideService::getLocationOutfit(Locati
     }
 }
 
-#define CHECK_LOCATION(TYPE, CHECK_CODE)                                                             \
-    if (actorOutfitAssignments.at(target).locationOutfits.contains(LocationType::TYPE) && (CHECK_CODE)) \
-        return std::optional<LocationType>(LocationType::TYPE);
-
-#define CHECK_WEATHER_LOCATIONS()                                                                         \
-    CHECK_LOCATION(CitySnow, keywords.contains("LocTypeCity") && weather_flags.snowy);                                    \
-    CHECK_LOCATION(CityRain, keywords.contains("LocTypeCity") && weather_flags.rainy);                                    \
-    CHECK_LOCATION(TownSnow, keywords.contains("LocTypeTown") + keywords.contains("LocTypeCity") && weather_flags.snowy); \
-    CHECK_LOCATION(TownRain, keywords.contains("LocTypeTown") + keywords.contains("LocTypeCity") && weather_flags.rainy); \
-    CHECK_LOCATION(WorldSnow, weather_flags.snowy);                                                                       \
-    CHECK_LOCATION(WorldRain, weather_flags.rainy);                                                                       \
-
-// Priority is as follows: Actions > Specific Locations > Generic Interiors > Weather Events > Generic Locations
-std::optional<LocationType> ArmorAddonOverrideService::checkLocationType(const std::unordered_set<std::string>& keywords,
-                                                                         const WeatherFlags& weather_flags,
-                                                                         const GameDayPart& day_part,
-                                                                         RE::Actor* target) {
-    // target must be loaded, and assigned
-    if (!actorOutfitAssignments.contains(target) || !target || !target->Is3DLoaded())
+RE::BSFixedString ArmorAddonOverrideService::getLocationOutfitName(LocationType location, RE::Actor* target) const {
+    const auto assignment = actorOutfitAssignments.find(target);
+    if (assignment == actorOutfitAssignments.end())
         return {};
+    const auto it = assignment->second.locationOutfits.find(location);
+    if (it == assignment->second.locationOutfits.end())
+        return {};
+    const auto outfit = outfits.find(it->second);
+    return outfit != outfits.end() ? outfit->second.papyrusName() : RE::BSFixedString(it->second.c_str());
+}
+
+void ActorContextBatch::clear() {
+    actors.clear();
+    contextBits.clear();
+    assignmentMasks.clear();
+    results.clear();
+    resolved.clear();
+}
+
+void ActorContextBatch::reserve(std::size_t count) {
+    actors.reserve(count);
+    contextBits.reserve(count);
+    assignmentMasks.reserve(count);
+    results.reserve(count);
+    resolved.reserve(count);
+}
+
+void ActorContextBatch::push(RE::Actor* actor, std::uint32_t context, std::uint32_t assignmentMask) {
+    actors.push_back(actor);
+    contextBits.push_back(context);
+    assignmentMasks.push_back(assignmentMask);
+}
+
+namespace {
+    struct LocationRung {
+        LocationType type;
+        std::uint32_t required;// every one of these LocationContext bits must be set
+    };
+
+    using namespace LocationContext;
+
+    constexpr LocationRung kActionRungs[] = {
+        {LocationType::LoveScene, kLoveScene},
+        {LocationType::Mounting, kMounted},
+        {LocationType::Swimming, kSwimming},
+        {LocationType::Sleeping, kSleeping},
+        {LocationType::InWater, kInWater},
+        {LocationType::Combat, kInCombat},
+    };
+
+    constexpr LocationRung kWeatherRungs[] = {
+        {LocationType::CitySnow, kCity | kSnowy},
+        {LocationType::CityRain, kCity | kRainy},
+        {LocationType::TownSnow, kTownOrCity | kSnowy},
+        {LocationType::TownRain, kTownOrCity | kRainy},
+        {LocationType::WorldSnow, kSnowy},
+        {LocationType::WorldRain, kRainy},
+    };
+
+    constexpr LocationRung kSpecificRungs[] = {
+        {LocationType::PlayerHome, kPlayerHouse | kInterior},
+        {LocationType::Castle, kCastle},
+        {LocationType::Temple, kTemple | kInterior},
+        {LocationType::GuildHall, kGuild | kInterior},
+        {LocationType::Jail, kJail | kInterior},
+        {LocationType::Farm, kFarm},
+        {LocationType::Military, kMilitary},
+        {LocationType::Inn, kInn | kInterior},
+        {LocationType::Store, kStore | kInterior},
+        {LocationType::Dungeon, kDungeon | kInterior},
+    };
+
+    constexpr LocationRung kInteriorRungs[] = {
+        {LocationType::CityInterior, kCity | kInterior},
+        {LocationType::TownInterior, kTownOrCity | kInterior},
+        {LocationType::WorldInterior, kInterior},
+    };
 
-    RE::TESObjectCELL* cell = target->GetParentCell();
-    bool inInterior = false;
-
-    if (cell) {
-        inInterior = cell->IsInteriorCell();
+    // A city is considered a town, so it will use the town outfit unless a city one is selected.
+    constexpr LocationRung kGenericRungs[] = {
+        {LocationType::CityNight, kCity | kNight},
+        {LocationType::City, kCity},
+        {LocationType::TownNight, kTownOrCity | kNight},
+        {LocationType::Town, kTownOrCity},
+        {LocationType::WorldNight, kNight},
+    };
+
+    // Priority is as follows: Actions > Specific Locations > Generic Interiors > Weather Events > Generic Locations.
+    // With climate priority enabled, weather events move up to right after actions.
+    template <std::size_t... N>
+    constexpr auto concatRungs(const LocationRung (&... parts)[N]) {
+        std::array<LocationRung, (N + ...)> out{};
+        std::size_t i = 0;
+        ((std::ranges::copy(parts, out.begin() + i), i += N), ...);
+        return out;
     }
 
-    auto& cacheService = OutfitSystemCacheService::GetSingleton();
-
-    std::optional<OutfitSystemCacheService::ActorStateCache> actorStateCacheOpt = cacheService.GetStateForActor(target);
-
-    CHECK_LOCATION(LoveScene, actorStateCacheOpt.has_value() ? actorStateCacheOpt.value().loveScene : false);
-    CHECK_LOCATION(Mounting, target->IsOnMount());
-    CHECK_LOCATION(Swimming, target->AsActorState()->IsSwimming());
-    CHECK_LOCATION(Sleeping, REUtilities::IsActorSleeping(target));
-    CHECK_LOCATION(InWater, target->IsInWater());
-    CHECK_LOCATION(Combat, target->IsInCombat());
-
-    if (climatePriorityEnabled) {
-        CHECK_WEATHER_LOCATIONS()
+    constexpr auto kLadder = concatRungs(kActionRungs, kSpecificRungs, kInteriorRungs, kWeatherRungs, kGenericRungs);
+    constexpr auto kClimatePriorityLadder = concatRungs(kActionRungs, kWeatherRungs, kSpecificRungs, kInteriorRungs, kGenericRungs);
+}
+
+std::uint32_t ArmorAddonOverrideService::locationTypeBit(LocationType location) noexcept {
+    switch (location) {
+        case LocationType::World: return 1u << 0;
+        case LocationType::WorldNight: return 1u << 1;
+        case LocationType::WorldSnow: return 1u << 2;
+        case LocationType::WorldRain: return 1u << 3;
+        case LocationType::WorldInterior: return 1u << 4;
+        case LocationType::Town: return 1u << 5;
+        case LocationType::TownNight: return 1u << 6;
+        case LocationType::TownSnow: return 1u << 7;
+        case LocationType::TownRain: return 1u << 8;
+        case LocationType::TownInterior: return 1u << 9;
+        case LocationType::City: return 1u << 10;
+        case LocationType::CityNight: return 1u << 11;
+        case LocationType::CitySnow: return 1u << 12;
+        case LocationType::CityRain: return 1u << 13;
+        case LocationType::CityInterior: return 1u << 14;
+        case LocationType::Combat: return 1u << 15;
+        case LocationType::InWater: return 1u << 16;
+        case LocationType::Sleeping: return 1u << 17;
+        case LocationType::Swimming: return 1u << 18;
+        case LocationType::Mounting: return 1u << 19;
+        case LocationType::LoveScene: return 1u << 20;
+        case LocationType::Dungeon: return 1u << 21;
+        case LocationType::PlayerHome: return 1u << 22;
+        case LocationType::Inn: return 1u << 23;
+        case LocationType::Store: return 1u << 24;
+        case LocationType::GuildHall: return 1u << 25;
+        case LocationType::Castle: return 1u << 26;
+        case LocationType::Temple: return 1u << 27;
+        case LocationType::Farm: return 1u << 28;
+        case LocationType::Jail: return 1u << 29;
+        case LocationType::Military: return 1u << 30;
+        default: return 0;
     }
+}
 
-    //Specific locations
-    CHECK_LOCATION(PlayerHome, keywords.contains("LocTypePlayerHouse") && inInterior);
-    CHECK_LOCATION(Castle, keywords.contains("LocTypeCastle"));
-    CHECK_LOCATION(Temple, keywords.contains("LocTypeTemple") && inInterior);
-    CHECK_LOCATION(GuildHall, keywords.contains("LocTypeGuild") && inInterior);
-    CHECK_LOCATION(Jail, keywords.contains("LocTypeJail") && inInterior);
-    CHECK_LOCATION(Farm, keywords.contains("LocTypeFarm") || keywords.contains("LocTypeLumberMill"));
-    CHECK_LOCATION(Military, keywords.contains("LocTypeMilitaryCamp") || keywords.contains("LocTypeBarracks") || keywords.contains("LocTypeMilitaryFort"));
-    CHECK_LOCATION(Inn, keywords.contains("LocTypeInn") && inInterior);
-    CHECK_LOCATION(Store, keywords.contains("LocTypeStore") && inInterior);
-    CHECK_LOCATION(Dungeon, keywords.contains("LocTypeDungeon") && inInterior);
+std::uint32_t ArmorAddonOverrideService::locationContextFromKeywords(const std::unordered_set<std::string>& keywords) noexcept {
+    std::uint32_t bits = LocationContext::kNone;
+    if (keywords.contains("LocTypeCity")) bits |= LocationContext::kCity | LocationContext::kTownOrCity;
+    if (keywords.contains("LocTypeTown")) bits |= LocationContext::kTownOrCity;
+    if (keywords.contains("LocTypePlayerHouse")) bits |= LocationContext::kPlayerHouse;
+    if (keywords.contains("LocTypeCastle")) bits |= LocationContext::kCastle;
+    if (keywords.contains("LocTypeTemple")) bits |= LocationContext::kTemple;
+    if (keywords.contains("LocTypeGuild")) bits |= LocationContext::kGuild;
+    if (keywords.contains("LocTypeJail")) bits |= LocationContext::kJail;
+    if (keywords.contains("LocTypeFarm") || keywords.contains("LocTypeLumberMill")) bits |= LocationContext::kFarm;
+    if (keywords.contains("LocTypeMilitaryCamp") || keywords.contains("LocTypeBarracks") || keywords.contains("LocTypeMilitaryFort")) bits |= LocationContext::kMilitary;
+    if (keywords.contains("LocTypeInn")) bits |= LocationContext::kInn;
+    if (keywords.contains("LocTypeStore")) bits |= LocationContext::kStore;
+    if (keywords.contains("LocTypeDungeon")) bits |= LocationContext::kDungeon;
+    return bits;
+}
+
+std::uint32_t ArmorAddonOverrideService::locationContextFromWorld(const WeatherFlags& weather_flags, const GameDayPart& day_part) noexcept {
+    std::uint32_t bits = LocationContext::kNone;
+    if (weather_flags.snowy) bits |= LocationContext::kSnowy;
+    if (weather_flags.rainy) bits |= LocationContext::kRainy;
+    if (day_part == GameDayPart::Night) bits |= LocationContext::kNight;
+    return bits;
+}
+
+std::uint32_t ArmorAddonOverrideService::locationContextForActor(RE::Actor* target) {
+    std::uint32_t bits = LocationContext::kNone;
+    if (!target)
+        return bits;
 
-    // Generic interiors take priority over weather events
-    CHECK_LOCATION(CityInterior, keywords.contains("LocTypeCity") && inInterior);
-    CHECK_LOCATION(TownInterior, keywords.contains("LocTypeTown") + keywords.contains("LocTypeCity") && inInterior);
-    CHECK_LOCATION(WorldInterior, inInterior);
+    RE::TESObjectCELL* cell = target->GetParentCell();
+    if (cell && cell->IsInteriorCell()) bits |= LocationContext::kInterior;
 
-    // Weather takes priority over regular generic locations
-    if (!climatePriorityEnabled) {
-        CHECK_WEATHER_LOCATIONS()
+    auto& cacheService = OutfitSystemCacheService::GetSingleton();
+    std::optional<OutfitSystemCacheService::ActorStateCache> actorStateCacheOpt = cacheService.GetStateForActor(target);
+
+    if (actorStateCacheOpt.has_value() && actorStateCacheOpt.value().loveScene) bits |= LocationContext::kLoveScene;
+    if (target->IsOnMount()) bits |= LocationContext::kMounted;
+    if (target->AsActorState()->IsSwimming()) bits |= LocationContext::kSwimming;
+    if (REUtilities::IsActorSleeping(target)) bits |= LocationContext::kSleeping;
+    if (target->IsInWater()) bits |= LocationContext::kInWater;
+    if (target->IsInCombat()) bits |= LocationContext::kInCombat;
+    return bits;
+}
+
+std::uint32_t ArmorAddonOverrideService::assignmentMaskForActor(RE::Actor* target) const {
+    auto it = actorOutfitAssignments.find(target);
+    if (it == actorOutfitAssignments.end())
+        return 0;
+    std::uint32_t mask = 0;
+    for (const auto& location : it->second.locationOutfits | std::views::keys)
+        mask |= locationTypeBit(location);
+    return mask;
+}
+
+std::span<const LocationType> ArmorAddonOverrideService::classifyActors(ActorContextBatch& batch) const {
+    const std::size_t count = batch.size();
+    batch.results.assign(count, LocationType::World);// World by default
+    batch.resolved.assign(count, 0);
+
+    const std::uint32_t* context = batch.contextBits.data();
+    const std::uint32_t* masks = batch.assignmentMasks.data();
+    LocationType* results = batch.results.data();
+    std::uint8_t* resolved = batch.resolved.data();
+
+    // Walk the ladder rung by rung across all actors. The inner loop is branch-free over plain arrays so that the
+    // compiler can vectorize it; the first rung that matches an actor wins.
+    const auto& ladder = climatePriorityEnabled ? kClimatePriorityLadder : kLadder;
+    for (const auto& rung : ladder) {
+        const std::uint32_t bit = locationTypeBit(rung.type);
+        const std::uint32_t required = rung.required;
+        for (std::size_t i = 0; i < count; i++) {
+            const std::uint8_t hit = !resolved[i] & ((masks[i] & bit) != 0) & ((context[i] & required) == required);
+            results[i] = hit ? rung.type : results[i];
+            resolved[i] |= hit;
+        }
     }
 
-    // Generic Locations
-    CHECK_LOCATION(CityNight, keywords.contains("LocTypeCity") && day_part == GameDayPart::Night);
-    CHECK_LOCATION(City, keywords.contains("LocTypeCity"));
+    return {batch.results.data(), count};
+}
 
-    // A city is considered a town, so it will use the town outfit unless a city one is selected.
-    CHECK_LOCATION(TownNight, keywords.contains("LocTypeTown") + keywords.contains("LocTypeCity") && day_part == GameDayPart::Night);
-    CHECK_LOCATION(Town, keywords.contains("LocTypeTown") + keywords.contains("LocTypeCity"));
+std::optional<LocationType> ArmorAddonOverrideService::checkLocationType(const std::unordered_set<std::string>& keywords,
+                                                                         const WeatherFlags& weather_flags,
+                                                                         const GameDayPart& day_part,
+                                                                         RE::Actor* target) {
+    // target must be loaded, and assigned
+    if (!actorOutfitAssignments.contains(target) || !target || !target->Is3DLoaded())
+        return {};
 
-    CHECK_LOCATION(WorldNight, day_part == GameDayPart::Night);
-    // return world by default
-    return LocationType::World;
+    ActorContextBatch batch;
+    batch.push(target,
+               locationContextFromKeywords(keywords) | locationContextFromWorld(weather_flags, day_part) | locationContextForActor(target),
+               assignmentMaskForActor(target));
+    return classifyActors(batch).front();
 }
 
 bool ArmorAddonOverrideService::shouldOverride(RE::Actor* target) const noexcept {
@@ -396,13 +755,20 @@ bool ArmorAddonOverrideService::shouldOverride(RE::Actor* target) const noexcept
         return false;
     return true;
 }
-void ArmorAddonOverrideService::getOutfitNames(std::vector<std::string>& out, bool favoritesOnly) const {
+void ArmorAddonOverrideService::getOutfitNames(std::vector<RE::BSFixedString>& out, bool favoritesOnly, std::size_t offset, std::size_t limit) const {
     out.clear();
-    auto& list = outfits;
-    out.reserve(list.size());
-    for (auto it = list.cbegin(); it != list.cend(); ++it)
-        if (!favoritesOnly || it->second.m_favorited)
-            out.push_back(it->second.m_name);
+    const auto& list = favoritesOnly ? outfits.favorites() : outfits.sorted();
+    if (offset >= list.size())
+        return;
+    const auto count = std::min(limit, list.size() - offset);
+    out.reserve(count);
+    // Walking from whichever end is closer halves the worst case for late pages.
+    auto it = offset <= list.size() / 2 ? std::next(list.begin(), offset) : std::prev(list.end(), list.size() - offset);
+    for (std::size_t i = 0; i < count; ++i, ++it)
+        out.push_back(it->outfit->second.papyrusName());
+}
+std::size_t ArmorAddonOverrideService::countOutfits(bool favoritesOnly) const noexcept {
+    return favoritesOnly ? outfits.favorites().size() : outfits.size();
 }
 
 void ArmorAddonOverrideService::setEnabled(const bool flag) noexcept { enabled = flag; }
@@ -425,36 +791,168 @@ void ArmorAddonOverrideService::setNPCInventoryManagementMode(InventoryManagemen
     npcInventoryManagementMode = mode;
 }
 
-proto::OutfitSystem ArmorAddonOverrideService::save() {
+proto::OutfitSystem ArmorAddonOverrideService::saveForExport() {
+    // Starts from the settings, so the hidden library outfits come along; empty fields aren't printed to JSON.
+    proto::OutfitSystem out = saveSettings();
+    for (const auto& actorAssn : actorOutfitAssignments) {
+        RE::Actor* actor = actorAssn.first;
+        if (!actor)
+            continue;
+        proto::ActorOutfitAssignment assnOut;
+        writeAssignments(actorAssn.second, &assnOut);
+        out.mutable_actor_outfit_assignments()->insert({Forms::GetFormString(actor), assnOut});
+    }
+    out.mutable_outfits()->Reserve(static_cast<int>(outfits.size()));
+    for (const auto& entry : outfits.sorted()) {
+        materialize(entry.outfit->second);
+        *out.add_outfits() = entry.outfit->second.saveForExport();
+    }
+    return out;
+}
+
+proto::OutfitSystem ArmorAddonOverrideService::saveSettings() const {
     proto::OutfitSystem out;
     out.set_enabled(enabled);
     out.set_quickslots_enabled(quickSlotEnabled);
     out.set_climate_priority_enabled(climatePriorityEnabled);
     out.set_player_inventory_management_mode(static_cast<uint32_t>(playerInventoryManagementMode));
     out.set_npc_inventory_management_mode(static_cast<uint32_t>(npcInventoryManagementMode));
-    for (const auto& actorAssn : actorOutfitAssignments) {
-        // Store a reference to the actor
-        RE::Actor* actor = actorAssn.first;
+    for (const auto& hidden : hiddenLibraryOutfits)
+        out.add_hidden_library_outfits(hidden.data(), hidden.size());
+    return out;
+}
 
-        std::string actorFormString = Forms::GetFormString(actor);
+std::size_t ArmorAddonOverrideService::outfitChunkIndex(const cobb::istring& name) noexcept {
+    return hashString(kHashBasis, std::string_view(name.data(), name.size())) % ce_outfitChunkCount;
+}
 
-        proto::ActorOutfitAssignment assnOut;
-        assnOut.set_current_outfit_name(actorAssn.second.currentOutfitName.data(),
-                                        actorAssn.second.currentOutfitName.size());
+std::uint64_t ArmorAddonOverrideService::hashOutfitChunk(std::span<const Outfit* const> chunk) noexcept {
+    std::uint64_t hash = kHashBasis;
+    for (const auto* outfit : chunk) {
+        hash = hashString(hash, outfit->m_name);
+        hash = hashValue(hash, outfit->m_favorited);
+        std::uint64_t armors = 0;
+        for (const auto* armor : outfit->m_armors) {
+            if (armor)
+                armors += mixFormID(armor->formID);
+        }
+        hash = hashValue(hash, armors);
+        hash = hashValue(hash, outfit->m_armors.size());
+    }
+    return hash;
+}
+
+std::uint64_t ArmorAddonOverrideService::hashAssignments() const noexcept {
+    std::uint64_t hash = kHashBasis;
+    for (const auto& actorAssn : actorOutfitAssignments) {
+        hash = hashValue(hash, actorAssn.first ? actorAssn.first->formID : 0);
+        hash = hashString(hash, std::string_view(actorAssn.second.currentOutfitName.data(), actorAssn.second.currentOutfitName.size()));
         for (const auto& locationBasedOutfit : actorAssn.second.locationOutfits) {
-            assnOut.mutable_location_based_outfits()
-                ->insert({
-                    static_cast<std::uint32_t>(locationBasedOutfit.first),
-                    std::string(locationBasedOutfit.second.data(), locationBasedOutfit.second.size())
-                });
+            hash = hashValue(hash, locationBasedOutfit.first);
+            hash = hashString(hash, std::string_view(locationBasedOutfit.second.data(), locationBasedOutfit.second.size()));
         }
-        out.mutable_actor_outfit_assignments()->insert({actorFormString, assnOut});
+        hash = hashValue(hash, actorAssn.second.locationOutfits.size());
     }
-    for (const auto& outfit : outfits) {
-        auto newOutfit = out.add_outfits();
-        *newOutfit = outfit.second.save();
+    return hash;
+}
+
+void ArmorAddonOverrideService::saveOutfitChunks(std::vector<std::string_view>& out) {
+    // Walking the outfits in a fixed order keeps each chunk's content (and so its hash) the same between saves.
+    std::array<std::vector<const Outfit*>, ce_outfitChunkCount> chunks;
+    for (const auto& entry : outfits.sorted()) {
+        auto& outfit = *entry.outfit;
+        if (isGlobalLibraryCopy(outfit.second))
+            continue;
+        // Saves have to stand on their own (a later export can replace the outfit library's files), so every outfit
+        // still waiting in either library is read here and saved in full. Outfits imported from the outfit library
+        // therefore stay unread only until the first save after the import. A global library outfit that's still
+        // waiting here is one whose favorite flag changed; unchanged ones were skipped above.
+        if (outfit.second.isPending())
+            materialize(outfit.second);
+        chunks[outfitChunkIndex(outfit.first)].push_back(&outfit.second);
+    }
+    out.clear();
+    for (std::size_t i = 0; i < ce_outfitChunkCount; ++i) {
+        auto& cached = outfitChunkCache[i];
+        if (chunks[i].empty()) {
+            cached = SerializedChunk();
+            continue;
+        }
+        const auto hash = hashOutfitChunk(chunks[i]);
+        if (!cached.valid || cached.hash != hash) {
+            proto::OutfitSystemChunk chunk;
+            Forms::FormReferenceWriter refs;
+            chunk.set_content_hash(hash);
+            chunk.mutable_outfits()->Reserve(static_cast<int>(chunks[i].size()));
+            for (const auto* outfit : chunks[i]) {
+                *chunk.add_outfits() = outfit->save(refs);
+            }
+            refs.store(chunk.mutable_plugins());
+            serializeChunk(chunk, cached.blob);
+            cached.hash = hash;
+            cached.valid = true;
+        }
+        out.emplace_back(cached.blob);
+    }
+}
+
+std::string_view ArmorAddonOverrideService::saveAssignments() {
+    auto& cached = assignmentsChunkCache;
+    const auto hash = hashAssignments();
+    if (!cached.valid || cached.hash != hash) {
+        proto::OutfitSystemChunk chunk;
+        Forms::FormReferenceWriter refs;
+        chunk.set_content_hash(hash);
+        for (const auto& actorAssn : actorOutfitAssignments) {
+            proto::ActorOutfitAssignment* assnOut = chunk.add_actor_assignments();
+            if (!refs.write(actorAssn.first, assnOut->mutable_actor())) {
+                chunk.mutable_actor_assignments()->RemoveLast();
+                continue;
+            }
+            writeAssignments(actorAssn.second, assnOut);
+        }
+        refs.store(chunk.mutable_plugins());
+        serializeChunk(chunk, cached.blob);
+        cached.hash = hash;
+        cached.valid = true;
+    }
+    return cached.blob;
+}
+
+void ArmorAddonOverrideService::loadChunk(const proto::OutfitSystemChunk& chunk, std::span<const char> serialized) {
+    Forms::ResolutionContext forms(chunk.plugins());
+
+    if (chunk.outfits_size() > 0) {
+        std::vector<const Outfit*> loaded;
+        loaded.reserve(chunk.outfits_size());
+        for (const auto& outfitData : chunk.outfits()) {
+            auto created = outfits.emplace(std::piecewise_construct,
+                                           std::forward_as_tuple(cobb::istring(outfitData.name().data(), outfitData.name().size())),
+                                           std::forward_as_tuple(outfitData, forms));
+            loaded.push_back(&created.first->second);
+        }
+        // If everything resolved the same way it was saved, the record can be written back as-is next time.
+        const auto& firstName = chunk.outfits(0).name();
+        const auto index = outfitChunkIndex(cobb::istring(firstName.data(), firstName.size()));
+        if (hashOutfitChunk(loaded) == chunk.content_hash()) {
+            auto& cached = outfitChunkCache[index];
+            cached.blob.assign(serialized.data(), serialized.size());
+            cached.hash = chunk.content_hash();
+            cached.valid = true;
+        }
+    }
+
+    if (chunk.actor_assignments_size() > 0) {
+        for (const auto& actorAssn : chunk.actor_assignments()) {
+            RE::Actor* actor = skyrim_cast<RE::Actor*>(forms.resolve(actorAssn.actor()));
+            actorOutfitAssignments[actor] = readAssignments(actorAssn);
+        }
+        if (hashAssignments() == chunk.content_hash()) {
+            assignmentsChunkCache.blob.assign(serialized.data(), serialized.size());
+            assignmentsChunkCache.hash = chunk.content_hash();
+            assignmentsChunkCache.valid = true;
+        }
     }
-    return out;
 }
 //
 void ArmorAddonOverrideService::dump() const {
@@ -0,0 +1,1168 @@
+#include "ArmorCatalog.h"
+
+#include <Windows.h>
+#include <emmintrin.h>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <mutex>
+#include <numeric>
+#include <queue>
+
+#include "Utility.h"
+#include "cobb/utf8naturalsort.h"
+#include "cobb/utf8string.h"
+
+namespace {
+    std::mutex g_lock;
+    ArmorCatalog::PendingBuild g_pending;
+
+    // Strings copied into the catalog's pool. Their views are only taken once the pool has stopped growing.
+    struct PooledString {
+        std::vector<std::string_view>* column;
+        ArmorCatalog::Index row;
+        std::uint32_t offset;
+        std::uint32_t length;
+    };
+
+    // Substring test that checks the needle's first and last byte at 16 candidate positions per step and only runs a
+    // full compare where both match.
+    bool Contains(std::string_view haystack, std::string_view needle) {
+        const std::size_t length = needle.size();
+        if (length == 0)
+            return true;
+        if (haystack.size() < length)
+            return false;
+        if (length == 1)
+            return haystack.find(needle.front()) != std::string_view::npos;
+
+        const char* data = haystack.data();
+        const std::size_t candidates = haystack.size() - length + 1;
+        const __m128i first = _mm_set1_epi8(needle.front());
+        const __m128i last = _mm_set1_epi8(needle.back());
+        std::size_t i = 0;
+        for (; i + 16 <= candidates; i += 16) {
+            const __m128i blockFirst = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            const __m128i blockLast = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + length - 1));
+            auto mask = static_cast<std::uint32_t>(
+                _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(blockFirst, first), _mm_cmpeq_epi8(blockLast, last))));
+            while (mask) {
+                const auto offset = i + std::countr_zero(mask);
+                if (std::memcmp(data + offset + 1, needle.data() + 1, length - 2) == 0)
+                    return true;
+                mask &= mask - 1;
+            }
+        }
+        for (; i < candidates; ++i) {
+            if (data[i] == needle.front() && std::memcmp(data + i + 1, needle.data() + 1, length - 1) == 0)
+                return true;
+        }
+        return false;
+    }
+
+    // Word boundaries for fuzzy matching. Non-ASCII bytes count as word characters so UTF-8 names stay whole.
+    bool IsWordByte(char c) {
+        const auto byte = static_cast<unsigned char>(c);
+        return byte >= 0x80 || (byte >= '0' && byte <= '9') || (byte >= 'a' && byte <= 'z') || c == '\'';
+    }
+
+    template <typename Callback>
+    void ForEachWord(std::string_view text, Callback&& callback) {
+        std::size_t i = 0;
+        while (i < text.size()) {
+            while (i < text.size() && !IsWordByte(text[i]))
+                ++i;
+            const auto start = i;
+            while (i < text.size() && IsWordByte(text[i]))
+                ++i;
+            if (i > start)
+                callback(text.substr(start, i - start));
+        }
+    }
+
+    constexpr std::size_t kMaxFuzzyWordLength = 32;
+
+    // Smallest edit distance between the query word and any prefix of the name word, so a half-typed word still
+    // matches. Returns maxEdits + 1 as soon as the distance is known to exceed maxEdits.
+    std::uint32_t PrefixEditDistance(std::string_view query, std::string_view word, std::uint32_t maxEdits) {
+        const auto m = query.size();
+        std::array<std::uint32_t, kMaxFuzzyWordLength + 1> column;
+        for (std::size_t i = 0; i <= m; ++i)
+            column[i] = static_cast<std::uint32_t>(i);
+        std::uint32_t best = column[m];
+        const auto columns = std::min(word.size(), m + maxEdits);
+        for (std::size_t j = 1; j <= columns; ++j) {
+            std::uint32_t diagonal = column[0];
+            column[0] = static_cast<std::uint32_t>(j);
+            std::uint32_t columnMin = column[0];
+            for (std::size_t i = 1; i <= m; ++i) {
+                const std::uint32_t above = column[i];
+                column[i] = std::min({above + 1, column[i - 1] + 1, diagonal + (query[i - 1] != word[j - 1] ? 1u : 0u)});
+                diagonal = above;
+                columnMin = std::min(columnMin, column[i]);
+            }
+            best = std::min(best, column[m]);
+            if (columnMin > maxEdits)
+                break;
+        }
+        return std::min(best, maxEdits + 1);
+    }
+
+    // Score of the best match of one query word against the words of a name, or 0 if none is close enough.
+    std::int32_t ScoreWord(std::string_view query, std::string_view name) {
+        std::int32_t best = 0;
+        ForEachWord(name, [&](std::string_view word) {
+            if (best >= 100)
+                return;
+            if (word == query)
+                best = 100;
+            else if (word.starts_with(query))
+                best = std::max(best, 80);
+            else if (word.find(query) != std::string_view::npos)
+                best = std::max(best, 60);
+            else if (best < 40 && query.size() >= 3 && query.size() <= kMaxFuzzyWordLength) {
+                const std::uint32_t maxEdits = query.size() <= 5 ? 1 : 2;
+                const auto distance = PrefixEditDistance(query, word, maxEdits);
+                if (distance <= maxEdits)
+                    best = std::max(best, 40 - 10 * static_cast<std::int32_t>(distance));
+            }
+        });
+        return best;
+    }
+
+    std::uint32_t Trigram(const char* text) {
+        return static_cast<std::uint32_t>(static_cast<unsigned char>(text[0])) << 16
+             | static_cast<std::uint32_t>(static_cast<unsigned char>(text[1])) << 8
+             | static_cast<std::uint32_t>(static_cast<unsigned char>(text[2]));
+    }
+
+    // Catalog cache file: a header, a table of sections and then the sections themselves, each aligned to 8 bytes.
+    // Strings are stored as offsets into the last section. Forms are stored by form ID and looked up again on load.
+    constexpr std::uint32_t kCacheMagic = 'SOEC';
+    constexpr std::uint32_t kCacheVersion = 2;
+
+    struct CacheHeader {
+        std::uint32_t magic;
+        std::uint32_t version;
+        std::uint64_t cacheKey;
+        std::uint64_t fileSize;
+        std::uint32_t sectionCount;
+        std::uint32_t padding;
+    };
+
+    struct CacheSection {
+        std::uint64_t offset;
+        std::uint64_t size;
+    };
+
+    struct StringRef {
+        std::uint32_t offset;
+        std::uint32_t length;
+    };
+
+    struct PluginRecord {
+        std::uint8_t compileIndex;
+        std::uint8_t light;
+        std::uint8_t excluded;
+        std::uint8_t padding;
+        std::uint16_t lightIndex;
+        std::uint16_t padding2;
+        std::uint32_t armorBegin;
+        std::uint32_t armorCount;
+        std::uint32_t outfitBegin;
+        std::uint32_t outfitCount;
+    };
+
+    void HashBytes(std::uint64_t& hash, const void* data, std::size_t size) {
+        // FNV-1a
+        const auto* bytes = static_cast<const unsigned char*>(data);
+        for (std::size_t i = 0; i < size; ++i) {
+            hash ^= bytes[i];
+            hash *= 0x100000001B3ull;
+        }
+    }
+
+    template <typename T>
+    void HashValue(std::uint64_t& hash, const T& value) {
+        HashBytes(hash, &value, sizeof(T));
+    }
+
+    class CacheWriter {
+    public:
+        template <typename T>
+        bool column(const std::vector<T>& values) {
+            static_assert(std::is_trivially_copyable_v<T>);
+            section(values.data(), values.size() * sizeof(T));
+            return true;
+        }
+
+        bool strings(const std::vector<std::string_view>& values) {
+            std::vector<StringRef> refs;
+            refs.reserve(values.size());
+            for (const auto value : values) {
+                // Most list names are the plain names, so equal strings are only stored once.
+                auto [it, added] = m_stringOffsets.try_emplace(value, static_cast<std::uint32_t>(m_strings.size()));
+                if (added)
+                    m_strings.append(value);
+                refs.push_back({it->second, static_cast<std::uint32_t>(value.size())});
+            }
+            return column(refs);
+        }
+
+        template <typename Form>
+        bool forms(const std::vector<Form*>& values) {
+            std::vector<RE::FormID> ids;
+            ids.reserve(values.size());
+            for (const auto* form : values)
+                ids.push_back(form->formID);
+            return column(ids);
+        }
+
+        bool plugins(const std::vector<ArmorCatalog::Plugin>& values) {
+            std::vector<std::string_view> names;
+            std::vector<PluginRecord> records;
+            names.reserve(values.size());
+            records.reserve(values.size());
+            for (const auto& plugin : values) {
+                names.push_back(plugin.name);
+                records.push_back({plugin.compileIndex, plugin.light, plugin.excluded, 0, plugin.lightIndex, 0, plugin.armorBegin,
+                                   plugin.armorCount, plugin.outfitBegin, plugin.outfitCount});
+            }
+            return strings(names) && column(records);
+        }
+
+        std::string finish(std::uint64_t cacheKey) {
+            section(m_strings.data(), m_strings.size());
+            const auto tableSize = sizeof(CacheHeader) + m_sections.size() * sizeof(CacheSection);
+            for (auto& entry : m_sections)
+                entry.offset += tableSize;
+
+            CacheHeader header{kCacheMagic, kCacheVersion, cacheKey, tableSize + m_body.size(),
+                               static_cast<std::uint32_t>(m_sections.size()), 0};
+            std::string out;
+            out.reserve(header.fileSize);
+            out.append(reinterpret_cast<const char*>(&header), sizeof(header));
+            out.append(reinterpret_cast<const char*>(m_sections.data()), m_sections.size() * sizeof(CacheSection));
+            out.append(m_body);
+            return out;
+        }
+
+    private:
+        std::string m_body;
+        std::vector<CacheSection> m_sections;
+        std::string m_strings;
+        std::unordered_map<std::string_view, std::uint32_t> m_stringOffsets;
+
+        void section(const void* data, std::size_t size) {
+            m_body.resize((m_body.size() + 7) & ~std::size_t(7));
+            m_sections.push_back({m_body.size(), size});
+            m_body.append(static_cast<const char*>(data), size);
+        }
+    };
+
+    class CacheReader {
+    public:
+        // The string section is needed before any string column can be resolved, so it's taken out first.
+        bool open(const std::byte* data, std::size_t size, std::uint64_t cacheKey, std::string& stringsOut) {
+            if (size < sizeof(CacheHeader))
+                return false;
+            const auto* header = reinterpret_cast<const CacheHeader*>(data);
+            if (header->magic != kCacheMagic || header->version != kCacheVersion || header->cacheKey != cacheKey
+                || header->fileSize != size || header->sectionCount == 0
+                || sizeof(CacheHeader) + std::uint64_t(header->sectionCount) * sizeof(CacheSection) > size)
+                return false;
+            m_data = data;
+            m_sections = std::span(reinterpret_cast<const CacheSection*>(data + sizeof(CacheHeader)), header->sectionCount);
+            for (const auto& entry : m_sections) {
+                if (entry.offset % 8 != 0 || entry.offset > size || entry.size > size - entry.offset)
+                    return false;
+            }
+            const auto& strings = m_sections.back();
+            stringsOut.assign(reinterpret_cast<const char*>(data + strings.offset), strings.size);
+            m_strings = stringsOut;
+            m_sections = m_sections.first(m_sections.size() - 1);
+            return true;
+        }
+
+        // Every section has to have been consumed, or the file doesn't match this version's layout.
+        bool done() const { return m_next == m_sections.size(); }
+
+        template <typename T>
+        bool column(std::vector<T>& values) {
+            static_assert(std::is_trivially_copyable_v<T>);
+            if (m_next >= m_sections.size())
+                return false;
+            const auto& entry = m_sections[m_next++];
+            if (entry.size % sizeof(T) != 0)
+                return false;
+            values.resize(entry.size / sizeof(T));
+            if (entry.size)
+                std::memcpy(values.data(), m_data + entry.offset, entry.size);
+            return true;
+        }
+
+        bool strings(std::vector<std::string_view>& values) {
+            std::vector<StringRef> refs;
+            if (!column(refs))
+                return false;
+            values.resize(refs.size());
+            for (std::size_t i = 0; i < refs.size(); ++i) {
+                if (refs[i].offset > m_strings.size() || refs[i].length > m_strings.size() - refs[i].offset)
+                    return false;
+                values[i] = m_strings.substr(refs[i].offset, refs[i].length);
+            }
+            return true;
+        }
+
+        template <typename Form>
+        bool forms(std::vector<Form*>& values) {
+            std::vector<RE::FormID> ids;
+            if (!column(ids))
+                return false;
+            values.resize(ids.size());
+            for (std::size_t i = 0; i < ids.size(); ++i) {
+                values[i] = RE::TESForm::LookupByID<Form>(ids[i]);
+                if (!values[i])
+                    return false;
+            }
+            return true;
+        }
+
+        bool plugins(std::vector<ArmorCatalog::Plugin>& values) {
+            std::vector<std::string_view> names;
+            std::vector<PluginRecord> records;
+            if (!strings(names) || !column(records) || names.size() != records.size())
+                return false;
+            auto* dataHandler = RE::TESDataHandler::GetSingleton();
+            values.clear();
+            values.reserve(records.size());
+            for (std::size_t i = 0; i < records.size(); ++i) {
+                const auto& record = records[i];
+                // The hash already covers the load order; this only guards against a hash collision.
+                const auto* file = dataHandler->LookupModByName(names[i]);
+                if (!file || file->IsLight() != (record.light != 0)
+                    || (record.light ? file->GetSmallFileCompileIndex() != record.lightIndex : file->GetCompileIndex() != record.compileIndex))
+                    return false;
+                values.push_back({file->GetFilename(), file, record.compileIndex, record.lightIndex, record.light != 0,
+                                  record.excluded != 0, record.armorBegin, record.armorCount, record.outfitBegin, record.outfitCount});
+            }
+            return true;
+        }
+
+    private:
+        const std::byte* m_data = nullptr;
+        std::span<const CacheSection> m_sections;
+        std::size_t m_next = 0;
+        std::string_view m_strings;
+    };
+
+    class MappedFile {
+    public:
+        explicit MappedFile(const std::filesystem::path& path) {
+            m_file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (m_file == INVALID_HANDLE_VALUE)
+                return;
+            LARGE_INTEGER fileSize;
+            if (!GetFileSizeEx(m_file, &fileSize) || fileSize.QuadPart <= 0)
+                return;
+            m_mapping = CreateFileMappingW(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (!m_mapping)
+                return;
+            m_view = static_cast<const std::byte*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+            if (m_view)
+                m_size = static_cast<std::size_t>(fileSize.QuadPart);
+        }
+
+        ~MappedFile() {
+            if (m_view)
+                UnmapViewOfFile(m_view);
+            if (m_mapping)
+                CloseHandle(m_mapping);
+            if (m_file != INVALID_HANDLE_VALUE)
+                CloseHandle(m_file);
+        }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        const std::byte* data() const noexcept { return m_view; }
+        std::size_t size() const noexcept { return m_size; }
+
+    private:
+        HANDLE m_file = INVALID_HANDLE_VALUE;
+        HANDLE m_mapping = nullptr;
+        const std::byte* m_view = nullptr;
+        std::size_t m_size = 0;
+    };
+}
+
+ArmorCatalog::PendingBuild ArmorCatalog::BuildAsync() {
+    // Released after the lock: dropping the last reference to an std::async result waits for its thread.
+    PendingBuild previous;
+    std::lock_guard lock(g_lock);
+    if (g_pending.valid() && g_pending.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        return g_pending;
+    auto snapshot = TakeSnapshot(RE::TESDataHandler::GetSingleton());
+    previous = std::move(g_pending);
+    g_pending = std::async(std::launch::async, &ArmorCatalog::Build, std::move(snapshot)).share();
+    return g_pending;
+}
+
+std::shared_ptr<const ArmorCatalog> ArmorCatalog::Get() {
+    PendingBuild pending;
+    {
+        std::lock_guard lock(g_lock);
+        pending = g_pending;
+    }
+    // Only before the build queued on kDataLoaded has run; natives are called on the main thread.
+    if (!pending.valid())
+        pending = BuildAsync();
+    return pending.get();
+}
+
+std::span<const RE::FormID> ArmorCatalog::keywords(Index i) const {
+    return std::span<const RE::FormID>(keywordIDs).subspan(keywordOffsets[i], keywordOffsets[i + 1] - keywordOffsets[i]);
+}
+
+const ArmorCatalog::Plugin* ArmorCatalog::findPlugin(std::string_view filename) const {
+    const auto it = m_pluginsByName.find(filename);
+    return it != m_pluginsByName.end() ? &pluginTable[it->second] : nullptr;
+}
+
+const ArmorCatalog::Plugin* ArmorCatalog::findPlugin(const RE::TESFile* file) const {
+    if (!file || m_byLightIndex.empty())
+        return nullptr;
+    const auto index = file->IsLight() ? m_byLightIndex[file->GetSmallFileCompileIndex() & 0xFFF] : m_byCompileIndex[file->GetCompileIndex()];
+    return index != kNoPlugin ? &pluginTable[index] : nullptr;
+}
+
+std::span<const ArmorCatalog::Index> ArmorCatalog::armorsOf(const Plugin& plugin) const {
+    return std::span<const Index>(m_pluginArmors).subspan(plugin.armorBegin, plugin.armorCount);
+}
+
+std::span<const ArmorCatalog::Index> ArmorCatalog::outfitsOf(const Plugin& plugin) const {
+    return std::span<const Index>(m_pluginOutfits).subspan(plugin.outfitBegin, plugin.outfitCount);
+}
+
+std::string ArmorCatalog::GetCachePath() {
+    return GetRuntimeDirectory() + "Data\\SKSE\\Plugins\\SkyrimOutfitEquipmentSystemNG.catalog";
+}
+
+bool ArmorCatalog::IsExcludedPlugin(std::string_view filename) {
+    // List of default Bethesda plugins
+    static constexpr std::string_view excludedPlugins[] = {
+        "Skyrim.esm",
+        "Update.esm",
+        "Dawnguard.esm",
+        "HearthFires.esm",
+        "Dragonborn.esm",
+        "Skyrim_VR.esm"
+    };
+    for (const auto& plugin : excludedPlugins) {
+        if (plugin.size() == filename.size() && _strnicmp(filename.data(), plugin.data(), plugin.size()) == 0)
+            return true;
+    }
+    return false;
+}
+
+ArmorCatalog::Snapshot ArmorCatalog::TakeSnapshot(RE::TESDataHandler* dataHandler) {
+    Snapshot snapshot;
+    if (!dataHandler) {
+        LOG(warn, "DataHandler is null");
+        return snapshot;
+    }
+
+    const auto& armors = dataHandler->GetFormArray<RE::TESObjectARMO>();
+    snapshot.armors.reserve(armors.size());
+    for (auto* armor : armors) {
+        if (!armor)
+            continue;
+        std::uint8_t flags = 0;
+        if (!(armor->formFlags & RE::TESObjectARMO::RecordFlags::kNonPlayable))
+            flags |= kPlayable;
+        if (armor->templateArmor)
+            flags |= kTemplated;
+        if (armor->formEnchanting)
+            flags |= kEnchanted;
+        auto& entry = snapshot.armors.emplace_back(Snapshot::Armor{armor, armor->GetFile(0), static_cast<std::uint32_t>(armor->GetSlotMask()), flags,
+                                                                   armor->fullName, {}, 0});
+        if (!entry.fullName.empty()) {
+            entry.flags |= kHasFullName;
+        } else {
+            entry.fallbackName = REUtilities::get_editorID(armor);
+            if (entry.fallbackName.empty())
+                entry.fallbackName = fmt::format("Outfit_{:X}", armor->formID & 0xFFF);
+        }
+        for (std::uint32_t k = 0; k < armor->numKeywords; ++k) {
+            if (const auto* keyword = armor->keywords[k])
+                snapshot.keywordIDs.push_back(keyword->formID);
+        }
+        entry.keywordEnd = static_cast<Index>(snapshot.keywordIDs.size());
+    }
+
+    const auto& outfits = dataHandler->GetFormArray<RE::BGSOutfit>();
+    snapshot.outfits.reserve(outfits.size());
+    for (auto* outfit : outfits) {
+        if (!outfit)
+            continue;
+        auto name = REUtilities::get_editorID(outfit);
+        if (name.empty())
+            name = fmt::format("Outfit_{:X}", outfit->formID & 0xFFF);
+        snapshot.outfits.push_back({outfit, outfit->GetFile(0), std::move(name)});
+    }
+    return snapshot;
+}
+
+std::shared_ptr<const ArmorCatalog> ArmorCatalog::Build(Snapshot snapshot) {
+    const auto start = std::chrono::steady_clock::now();
+    auto catalog = std::make_shared<ArmorCatalog>();
+    catalog->keywordOffsets.push_back(0);
+    catalog->m_byCompileIndex.fill(kNoPlugin);
+    catalog->m_byLightIndex.assign(0x1000, kNoPlugin);
+
+    auto dataHandler = RE::TESDataHandler::GetSingleton();
+    if (!dataHandler) {
+        LOG(warn, "DataHandler is null");
+        return catalog;
+    }
+
+    const auto cacheKey = CacheKey(dataHandler, snapshot);
+    if (auto cached = LoadCache(dataHandler, cacheKey, snapshot)) {
+        const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+        LOG(info, "Loaded the armor catalog from its cache: {} armors and {} outfits from {} plugins in {} ms.",
+            cached->size(), cached->outfitForms.size(), cached->pluginTable.size(), elapsed.count());
+        return cached;
+    }
+
+    std::vector<PooledString> pooled;
+    const auto pool = [&](std::vector<std::string_view>& column, Index row, std::string_view text) {
+        pooled.push_back({&column, row, static_cast<std::uint32_t>(catalog->m_strings.size()), static_cast<std::uint32_t>(text.size())});
+        catalog->m_strings.append(text);
+    };
+    // Plugins are numbered in the order they're first seen here; buildPluginIndex puts them into load order.
+    const auto pluginFor = [&](const RE::TESFile* file) -> PluginIndex {
+        if (!file)
+            return kNoPlugin;
+        const bool light = file->IsLight();
+        auto& slot = light ? catalog->m_byLightIndex[file->GetSmallFileCompileIndex() & 0xFFF]
+                           : catalog->m_byCompileIndex[file->GetCompileIndex()];
+        if (slot == kNoPlugin) {
+            slot = static_cast<PluginIndex>(catalog->pluginTable.size());
+            const auto filename = file->GetFilename();
+            catalog->pluginTable.push_back({filename, file, file->GetCompileIndex(), file->GetSmallFileCompileIndex(), light,
+                                            IsExcludedPlugin(filename), 0, 0, 0, 0});
+        }
+        return slot;
+    };
+
+    const auto rows = snapshot.armors.size();
+    catalog->forms.reserve(rows);
+    catalog->names.reserve(rows);
+    catalog->searchKeys.reserve(rows);
+    catalog->plugins.reserve(rows);
+    catalog->slotMasks.reserve(rows);
+    catalog->flags.reserve(rows);
+    catalog->keywordOffsets.reserve(rows + 1);
+    catalog->keywordIDs = std::move(snapshot.keywordIDs);
+
+    std::string key;
+    for (const auto& armor : snapshot.armors) {
+        const auto row = static_cast<Index>(catalog->forms.size());
+        catalog->forms.push_back(armor.form);
+        catalog->plugins.push_back(pluginFor(armor.file));
+        catalog->slotMasks.push_back(armor.slotMask);
+        catalog->flags.push_back(armor.flags);
+        catalog->names.emplace_back();
+        catalog->searchKeys.emplace_back();
+        catalog->keywordOffsets.push_back(armor.keywordEnd);
+
+        // Copied into the pool rather than viewed in the game's string cache, which a later rename may free.
+        if (armor.flags & kHasFullName) {
+            const std::string_view fullName = armor.fullName.data();
+            pool(catalog->names, row, fullName);
+            key.clear();
+            cobb::utf8::fold(fullName, key);
+            pool(catalog->searchKeys, row, key);
+        } else {
+            pool(catalog->names, row, armor.fallbackName);
+        }
+    }
+
+    catalog->outfitForms.reserve(snapshot.outfits.size());
+    catalog->outfitNames.reserve(snapshot.outfits.size());
+    catalog->outfitPlugins.reserve(snapshot.outfits.size());
+    for (const auto& outfit : snapshot.outfits) {
+        const auto row = static_cast<Index>(catalog->outfitForms.size());
+        catalog->outfitForms.push_back(outfit.form);
+        catalog->outfitPlugins.push_back(pluginFor(outfit.file));
+        catalog->outfitNames.emplace_back();
+        pool(catalog->outfitNames, row, outfit.name);
+    }
+
+    const std::string_view strings = catalog->m_strings;
+    for (const auto& entry : pooled)
+        (*entry.column)[entry.row] = strings.substr(entry.offset, entry.length);
+    catalog->buildPluginIndex();
+    catalog->buildTrigramIndex();
+    catalog->buildAttributeIndex();
+    catalog->writeCache(cacheKey);
+    catalog->buildPapyrusNames(snapshot);
+
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    LOG(info, "Built the armor catalog: {} armors and {} outfits from {} plugins ({} trigrams) in {} ms.",
+        catalog->size(), catalog->outfitForms.size(), catalog->pluginTable.size(), catalog->m_trigramIndex.keys.size(), elapsed.count());
+    return catalog;
+}
+
+std::string ArmorCatalog::MakeSearchKey(std::string_view text) {
+    std::string key;
+    cobb::utf8::fold(text, key);
+    return key;
+}
+
+void ArmorCatalog::buildPluginIndex() {
+    std::vector<PluginIndex> order(pluginTable.size());
+    std::iota(order.begin(), order.end(), PluginIndex(0));
+    std::sort(order.begin(), order.end(), [this](PluginIndex a, PluginIndex b) {
+        return pluginTable[a].loadOrderKey() < pluginTable[b].loadOrderKey();
+    });
+    std::vector<PluginIndex> renumbered(pluginTable.size());
+    std::vector<Plugin> sorted;
+    sorted.reserve(pluginTable.size());
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        renumbered[order[i]] = static_cast<PluginIndex>(i);
+        sorted.push_back(pluginTable[order[i]]);
+    }
+    pluginTable = std::move(sorted);
+    for (auto* column : {&plugins, &outfitPlugins}) {
+        for (auto& plugin : *column) {
+            if (plugin != kNoPlugin)
+                plugin = renumbered[plugin];
+        }
+    }
+
+    buildLookups();
+
+    // Counting sort of the rows into one contiguous range per plugin, then each range with the given order.
+    const auto group = [this](const std::vector<PluginIndex>& owners, auto&& before, std::vector<Index>& out, Index Plugin::*begin,
+                              Index Plugin::*count) {
+        for (const auto owner : owners) {
+            if (owner != kNoPlugin)
+                ++(pluginTable[owner].*count);
+        }
+        std::vector<Index> cursors(pluginTable.size());
+        Index offset = 0;
+        for (std::size_t i = 0; i < pluginTable.size(); ++i) {
+            pluginTable[i].*begin = cursors[i] = offset;
+            offset += pluginTable[i].*count;
+        }
+        out.resize(offset);
+        for (Index row = 0; row < owners.size(); ++row) {
+            if (owners[row] != kNoPlugin)
+                out[cursors[owners[row]]++] = row;
+        }
+        for (const auto& plugin : pluginTable) {
+            const auto first = out.begin() + plugin.*begin;
+            std::stable_sort(first, first + plugin.*count, before);
+        }
+    };
+
+    // Armors are listed in natural order, equal names by form ID; outfit editor IDs in plain byte order.
+    std::vector<std::string> collationKeys(size());
+    for (Index row = 0; row < size(); ++row)
+        cobb::utf8::naturalkey(names[row], collationKeys[row]);
+    group(plugins, [&](Index a, Index b) {
+        if (const int order = collationKeys[a].compare(collationKeys[b]); order != 0)
+            return order < 0;
+        return forms[a]->formID < forms[b]->formID;
+    }, m_pluginArmors, &Plugin::armorBegin, &Plugin::armorCount);
+    group(outfitPlugins, [this](Index a, Index b) { return outfitNames[a] < outfitNames[b]; }, m_pluginOutfits,
+          &Plugin::outfitBegin, &Plugin::outfitCount);
+    buildListNames(collationKeys);
+
+    for (std::size_t i = 0; i < pluginTable.size(); ++i) {
+        const auto& plugin = pluginTable[i];
+        if (plugin.excluded)
+            continue;
+        if (plugin.armorCount)
+            m_armorMods.push_back(static_cast<PluginIndex>(i));
+        if (plugin.outfitCount)
+            m_outfitMods.push_back(static_cast<PluginIndex>(i));
+    }
+    const auto byName = [this](PluginIndex a, PluginIndex b) { return pluginTable[a].name < pluginTable[b].name; };
+    std::sort(m_armorMods.begin(), m_armorMods.end(), byName);
+    std::sort(m_outfitMods.begin(), m_outfitMods.end(), byName);
+}
+
+void ArmorCatalog::buildLookups() {
+    m_byCompileIndex.fill(kNoPlugin);
+    m_byLightIndex.assign(0x1000, kNoPlugin);
+    m_pluginsByName.clear();
+    m_pluginsByName.reserve(pluginTable.size());
+    for (std::size_t i = 0; i < pluginTable.size(); ++i) {
+        const auto& plugin = pluginTable[i];
+        (plugin.light ? m_byLightIndex[plugin.lightIndex & 0xFFF] : m_byCompileIndex[plugin.compileIndex]) = static_cast<PluginIndex>(i);
+        m_pluginsByName.emplace(plugin.name, static_cast<PluginIndex>(i));
+    }
+}
+
+void ArmorCatalog::buildPapyrusNames(const Snapshot& snapshot) {
+    // The pooled views aren't null-terminated, which the string table needs.
+    std::string buffer;
+    const auto intern = [&buffer](std::string_view text) {
+        buffer.assign(text);
+        return RE::BSFixedString(buffer.c_str());
+    };
+    papyrusNames.resize(size());
+    papyrusListNames.resize(size());
+    for (Index row = 0; row < size(); ++row) {
+        // Full names are interned already; only generated names and form ID suffixes need a string table lookup. A
+        // cached catalog's rows normally line up with the snapshot's; any that don't are interned from the copy.
+        const auto* armor = row < snapshot.armors.size() && snapshot.armors[row].form == forms[row] ? &snapshot.armors[row] : nullptr;
+        papyrusNames[row] = armor && has(row, kHasFullName) ? armor->fullName : intern(names[row]);
+        papyrusListNames[row] = listNames[row] == names[row] ? papyrusNames[row] : intern(listNames[row]);
+    }
+}
+
+void ArmorCatalog::buildListNames(const std::vector<std::string>& collationKeys) {
+    // Armors that share a display name within one plugin are told apart by their form ID. Rows with equal names have
+    // equal collation keys, so only runs of equal keys need checking.
+    std::vector<Index> duplicates;
+    for (const auto& plugin : pluginTable) {
+        const auto rows = armorsOf(plugin);
+        for (std::size_t start = 0, end = 0; start < rows.size(); start = end) {
+            end = start + 1;
+            while (end < rows.size() && collationKeys[rows[end]] == collationKeys[rows[start]])
+                ++end;
+            for (auto i = start; i < end; ++i) {
+                for (auto j = start; j < end; ++j) {
+                    if (i != j && names[rows[i]] == names[rows[j]]) {
+                        duplicates.push_back(rows[i]);
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    listNames = names;
+    std::vector<std::string> formatted;
+    formatted.reserve(duplicates.size());
+    std::size_t total = 0;
+    for (const auto row : duplicates) {
+        formatted.push_back(fmt::format("{} [{:08X}]", names[row], forms[row]->formID));
+        total += formatted.back().size();
+    }
+    m_listNameStrings.reserve(total);// no reallocation below, so the views stay valid
+    for (std::size_t i = 0; i < duplicates.size(); ++i) {
+        const auto offset = m_listNameStrings.size();
+        m_listNameStrings.append(formatted[i]);
+        listNames[duplicates[i]] = std::string_view(m_listNameStrings).substr(offset, formatted[i].size());
+    }
+}
+
+void ArmorCatalog::buildTrigramIndex() {
+    std::vector<std::uint64_t> pairs;
+    std::size_t total = 0;
+    for (const auto& key : searchKeys)
+        total += key.size() >= kTrigramLength ? key.size() - kTrigramLength + 1 : 0;
+    pairs.reserve(total);
+    for (Index row = 0; row < searchKeys.size(); ++row) {
+        const auto key = searchKeys[row];
+        for (std::size_t i = 0; i + kTrigramLength <= key.size(); ++i)
+            pairs.push_back(static_cast<std::uint64_t>(Trigram(key.data() + i)) << 32 | row);
+    }
+    m_trigramIndex.build(pairs);
+}
+
+void ArmorCatalog::buildAttributeIndex() {
+    std::vector<std::uint64_t> pairs;
+    pairs.reserve(keywordIDs.size());
+    for (Index row = 0; row < size(); ++row) {
+        for (const auto keyword : keywords(row))
+            pairs.push_back(static_cast<std::uint64_t>(keyword) << 32 | row);
+    }
+    m_keywordIndex.build(pairs);
+
+    m_bitmapWords = (size() + 63) / 64;
+    m_slotBitmaps.assign(32 * m_bitmapWords, 0);
+    m_flagBitmaps.assign(8 * m_bitmapWords, 0);
+    for (Index row = 0; row < size(); ++row) {
+        const auto word = row / 64;
+        const auto bit = std::uint64_t(1) << (row % 64);
+        for (auto mask = slotMasks[row]; mask; mask &= mask - 1)
+            m_slotBitmaps[std::countr_zero(mask) * m_bitmapWords + word] |= bit;
+        for (std::uint32_t mask = flags[row]; mask; mask &= mask - 1)
+            m_flagBitmaps[std::countr_zero(mask) * m_bitmapWords + word] |= bit;
+    }
+}
+
+void ArmorCatalog::PostingIndex::build(std::vector<std::uint64_t>& pairs) {
+    // Sorting the pairs groups them by key, with ascending rows within each key.
+    std::sort(pairs.begin(), pairs.end());
+    pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+    postings.reserve(pairs.size());
+    for (const auto pair : pairs) {
+        const auto key = static_cast<std::uint32_t>(pair >> 32);
+        if (keys.empty() || keys.back() != key) {
+            keys.push_back(key);
+            offsets.push_back(static_cast<Index>(postings.size()));
+        }
+        postings.push_back(static_cast<Index>(pair));
+    }
+    offsets.push_back(static_cast<Index>(postings.size()));
+}
+
+std::span<const ArmorCatalog::Index> ArmorCatalog::PostingIndex::find(std::uint32_t key) const {
+    const auto it = std::lower_bound(keys.begin(), keys.end(), key);
+    if (it == keys.end() || *it != key)
+        return {};
+    const auto slot = static_cast<std::size_t>(it - keys.begin());
+    return std::span<const Index>(postings).subspan(offsets[slot], offsets[slot + 1] - offsets[slot]);
+}
+
+void ArmorCatalog::query(const Query& query, std::vector<Index>& out) const {
+    out.clear();
+    const auto words = m_bitmapWords;
+    if (words == 0)
+        return;
+
+    std::vector<std::uint64_t> result(words, ~std::uint64_t(0));
+    if (const auto tail = size() % 64)
+        result.back() = (std::uint64_t(1) << tail) - 1;
+    std::vector<std::uint64_t> scratch(words);
+
+    const auto andWith = [&](const std::uint64_t* bits, bool negate) {
+        const auto flip = negate ? ~std::uint64_t(0) : 0;
+        for (std::size_t w = 0; w < words; ++w)
+            result[w] &= bits[w] ^ flip;
+    };
+    const auto slot = [&](int index) { return m_slotBitmaps.data() + index * words; };
+    const auto flag = [&](int index) { return m_flagBitmaps.data() + index * words; };
+    const auto setRows = [&](std::span<const Index> rows) {
+        for (const auto row : rows)
+            scratch[row / 64] |= std::uint64_t(1) << (row % 64);
+    };
+
+    for (auto mask = query.slotsAll; mask; mask &= mask - 1)
+        andWith(slot(std::countr_zero(mask)), false);
+    for (auto mask = query.slotsNone; mask; mask &= mask - 1)
+        andWith(slot(std::countr_zero(mask)), true);
+    if (query.slotsAny) {
+        std::fill(scratch.begin(), scratch.end(), 0);
+        for (auto mask = query.slotsAny; mask; mask &= mask - 1) {
+            const auto* bits = slot(std::countr_zero(mask));
+            for (std::size_t w = 0; w < words; ++w)
+                scratch[w] |= bits[w];
+        }
+        andWith(scratch.data(), false);
+    }
+    for (std::uint32_t mask = query.requiredFlags; mask; mask &= mask - 1)
+        andWith(flag(std::countr_zero(mask)), false);
+    for (std::uint32_t mask = query.excludedFlags; mask; mask &= mask - 1)
+        andWith(flag(std::countr_zero(mask)), true);
+
+    if (query.plugins) {
+        std::fill(scratch.begin(), scratch.end(), 0);
+        for (const auto plugin : *query.plugins) {
+            if (plugin < pluginTable.size())
+                setRows(armorsOf(pluginTable[plugin]));
+        }
+        andWith(scratch.data(), false);
+    }
+    for (const auto keyword : query.keywordsAll) {
+        std::fill(scratch.begin(), scratch.end(), 0);
+        setRows(m_keywordIndex.find(keyword));
+        andWith(scratch.data(), false);
+    }
+    if (!query.keywordsAny.empty()) {
+        std::fill(scratch.begin(), scratch.end(), 0);
+        for (const auto keyword : query.keywordsAny)
+            setRows(m_keywordIndex.find(keyword));
+        andWith(scratch.data(), false);
+    }
+    if (!query.name.empty()) {
+        std::vector<Index> matches;
+        search(query.name, matches);
+        std::fill(scratch.begin(), scratch.end(), 0);
+        setRows(matches);
+        andWith(scratch.data(), false);
+    }
+
+    for (std::size_t w = 0; w < words; ++w) {
+        for (auto bits = result[w]; bits; bits &= bits - 1)
+            out.push_back(static_cast<Index>(w * 64 + std::countr_zero(bits)));
+    }
+}
+
+void ArmorCatalog::searchFuzzy(std::string_view key, std::uint8_t requiredFlags, std::uint8_t excludedFlags, std::size_t limit,
+                               std::vector<Index>& out) const {
+    out.clear();
+    std::vector<std::string_view> words;
+    ForEachWord(key, [&](std::string_view word) { words.push_back(word); });
+    if (words.empty() || limit == 0)
+        return;
+
+    // Min-heap of the best `limit` matches so far; ties go to the earlier row, matching the plain search's order.
+    using Match = std::pair<std::int32_t, Index>;
+    const auto better = [](const Match& a, const Match& b) {
+        return a.first != b.first ? a.first > b.first : a.second < b.second;
+    };
+    std::priority_queue<Match, std::vector<Match>, decltype(better)> best(better);
+
+    for (Index row = 0; row < size(); ++row) {
+        const auto rowFlags = flags[row];
+        if (!(rowFlags & kHasFullName) || (rowFlags & requiredFlags) != requiredFlags || (rowFlags & excludedFlags))
+            continue;
+        const auto name = searchKeys[row];
+        std::int32_t score = 0;
+        for (const auto word : words) {
+            const auto wordScore = ScoreWord(word, name);
+            if (wordScore == 0) {
+                score = 0;
+                break;
+            }
+            score += wordScore;
+        }
+        if (score == 0)
+            continue;
+        if (name.starts_with(key))
+            score += name.size() == key.size() ? 100 : 50;
+        score -= static_cast<std::int32_t>(std::min<std::size_t>(name.size(), 64) / 8);// shorter names first
+
+        if (best.size() < limit)
+            best.emplace(score, row);
+        else if (better(Match(score, row), best.top())) {
+            best.pop();
+            best.emplace(score, row);
+        }
+    }
+
+    out.resize(best.size());
+    for (auto i = out.size(); i-- > 0; best.pop())
+        out[i] = best.top().second;
+}
+
+void ArmorCatalog::search(std::string_view key, std::vector<Index>& out) const {
+    out.clear();
+    if (key.size() < kTrigramLength) {
+        for (Index row = 0; row < size(); ++row) {
+            if (has(row, kHasFullName) && Contains(searchKeys[row], key))
+                out.push_back(row);
+        }
+        return;
+    }
+
+    // Every match has to contain every trigram of the key, so intersecting their posting lists (smallest first)
+    // leaves a handful of candidates that only need the final substring check.
+    std::vector<std::span<const Index>> lists;
+    lists.reserve(key.size() - kTrigramLength + 1);
+    for (std::size_t i = 0; i + kTrigramLength <= key.size(); ++i) {
+        const auto list = m_trigramIndex.find(Trigram(key.data() + i));
+        if (list.empty())
+            return;
+        lists.push_back(list);
+    }
+    std::sort(lists.begin(), lists.end(), [](const auto& a, const auto& b) { return a.size() < b.size(); });
+
+    std::vector<Index> candidates(lists.front().begin(), lists.front().end());
+    for (std::size_t l = 1; l < lists.size() && !candidates.empty(); ++l) {
+        if (lists[l].data() == lists[l - 1].data())// repeated trigram
+            continue;
+        auto cursor = lists[l].begin();
+        const auto end = lists[l].end();
+        std::size_t kept = 0;
+        for (const auto row : candidates) {
+            cursor = std::lower_bound(cursor, end, row);
+            if (cursor == end)
+                break;
+            if (*cursor == row)
+                candidates[kept++] = row;
+        }
+        candidates.resize(kept);
+    }
+
+    out.reserve(candidates.size());
+    for (const auto row : candidates) {
+        if (Contains(searchKeys[row], key))
+            out.push_back(row);
+    }
+}
+
+std::uint64_t ArmorCatalog::CacheKey(RE::TESDataHandler* dataHandler, const Snapshot& snapshot) {
+    std::uint64_t hash = 0xCBF29CE484222325ull;
+    HashValue(hash, kCacheVersion);
+    const std::filesystem::path dataDirectory = GetRuntimeDirectory() + "Data";
+    const auto hashFiles = [&](const auto& files) {
+        for (const auto* file : files) {
+            if (!file)
+                continue;
+            const std::string_view name = file->GetFilename();
+            HashValue(hash, name.size());
+            HashBytes(hash, name.data(), name.size());
+            HashValue(hash, file->GetCompileIndex());
+            HashValue(hash, file->GetSmallFileCompileIndex());
+            // An edited plugin keeps its place in the load order, so its size and timestamp have to be part of the key.
+            std::error_code error;
+            const auto path = dataDirectory / std::string(name);
+            const auto fileSize = std::filesystem::file_size(path, error);
+            HashValue(hash, error ? std::uintmax_t(0) : fileSize);
+            const auto writeTime = std::filesystem::last_write_time(path, error);
+            HashValue(hash, error ? std::int64_t(0) : static_cast<std::int64_t>(writeTime.time_since_epoch().count()));
+        }
+    };
+    hashFiles(dataHandler->compiledFileCollection.files);
+    hashFiles(dataHandler->compiledFileCollection.smallFiles);
+
+    // Names and keywords can change without any plugin changing: another language's .STRINGS files, keywords
+    // distributed from INI files, renames by other plugins. So the values the cache stores are part of its key too.
+    for (const auto& armor : snapshot.armors) {
+        HashValue(hash, armor.form->formID);
+        HashValue(hash, armor.slotMask);
+        HashValue(hash, armor.flags);
+        const std::string_view name = armor.flags & kHasFullName ? std::string_view(armor.fullName.data()) : std::string_view(armor.fallbackName);
+        HashValue(hash, name.size());
+        HashBytes(hash, name.data(), name.size());
+        HashValue(hash, armor.keywordEnd);
+    }
+    HashBytes(hash, snapshot.keywordIDs.data(), snapshot.keywordIDs.size() * sizeof(RE::FormID));
+    for (const auto& outfit : snapshot.outfits) {
+        HashValue(hash, outfit.form->formID);
+        HashValue(hash, outfit.name.size());
+        HashBytes(hash, outfit.name.data(), outfit.name.size());
+    }
+    return hash;
+}
+
+template <class Self, class Archive>
+bool ArmorCatalog::Transfer(Self& self, Archive& archive) {
+    return archive.forms(self.forms)
+        && archive.strings(self.names)
+        && archive.strings(self.searchKeys)
+        && archive.strings(self.listNames)
+        && archive.column(self.plugins)
+        && archive.column(self.slotMasks)
+        && archive.column(self.flags)
+        && archive.column(self.keywordOffsets)
+        && archive.column(self.keywordIDs)
+        && archive.forms(self.outfitForms)
+        && archive.strings(self.outfitNames)
+        && archive.column(self.outfitPlugins)
+        && archive.plugins(self.pluginTable)
+        && archive.column(self.m_pluginArmors)
+        && archive.column(self.m_pluginOutfits)
+        && archive.column(self.m_armorMods)
+        && archive.column(self.m_outfitMods)
+        && archive.column(self.m_trigramIndex.keys)
+        && archive.column(self.m_trigramIndex.offsets)
+        && archive.column(self.m_trigramIndex.postings)
+        && archive.column(self.m_keywordIndex.keys)
+        && archive.column(self.m_keywordIndex.offsets)
+        && archive.column(self.m_keywordIndex.postings)
+        && archive.column(self.m_slotBitmaps)
+        && archive.column(self.m_flagBitmaps);
+}
+
+std::shared_ptr<const ArmorCatalog> ArmorCatalog::LoadCache(RE::TESDataHandler* dataHandler, std::uint64_t cacheKey, const Snapshot& snapshot) {
+    if (!dataHandler)
+        return nullptr;
+    const std::filesystem::path path = GetCachePath();
+    std::error_code error;
+    if (!std::filesystem::exists(path, error))
+        return nullptr;
+
+    auto catalog = std::make_shared<ArmorCatalog>();
+    {
+        MappedFile file(path);
+        if (!file.data()) {
+            LOG(warn, "Failed to map the armor catalog cache.");
+            return nullptr;
+        }
+        CacheReader reader;
+        if (!reader.open(file.data(), file.size(), cacheKey, catalog->m_strings)) {
+            LOG(info, "The armor catalog cache is from another load order, language or version; rebuilding it.");
+            return nullptr;
+        }
+        if (!Transfer(*catalog, reader) || !reader.done()) {
+            LOG(warn, "The armor catalog cache is corrupt or refers to missing forms; rebuilding it.");
+            return nullptr;
+        }
+    }
+    catalog->m_bitmapWords = (catalog->size() + 63) / 64;
+    if (!catalog->validate()) {
+        LOG(warn, "The armor catalog cache is inconsistent; rebuilding it.");
+        return nullptr;
+    }
+    catalog->buildLookups();
+    catalog->buildPapyrusNames(snapshot);
+    return catalog;
+}
+
+void ArmorCatalog::writeCache(std::uint64_t cacheKey) const {
+    CacheWriter writer;
+    Transfer(*this, writer);
+    const auto contents = writer.finish(cacheKey);
+
+    // Written next to the cache and renamed over it, so a failed write never leaves a truncated file behind.
+    const std::string cacheFile = GetCachePath();
+    const std::string tempFile = cacheFile + ".tmp";
+    {
+        std::ofstream file(tempFile, std::ios::binary | std::ios::trunc);
+        file.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+        if (!file.good()) {
+            LOG(warn, "Failed to write the armor catalog cache to {}.", tempFile);
+            return;
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(tempFile, cacheFile, error);
+    if (error) {
+        LOG(warn, "Failed to replace the armor catalog cache: {}", error.message());
+        std::filesystem::remove(tempFile, error);
+    }
+}
+
+bool ArmorCatalog::validate() const {
+    const auto rows = size();
+    if (names.size() != rows || searchKeys.size() != rows || listNames.size() != rows || plugins.size() != rows
+        || slotMasks.size() != rows || flags.size() != rows || keywordOffsets.size() != rows + 1 || keywordOffsets.front() != 0
+        || keywordOffsets.back() != keywordIDs.size() || !std::is_sorted(keywordOffsets.begin(), keywordOffsets.end()))
+        return false;
+    if (outfitNames.size() != outfitForms.size() || outfitPlugins.size() != outfitForms.size())
+        return false;
+
+    const auto pluginCount = pluginTable.size();
+    if (pluginCount >= kNoPlugin)
+        return false;
+    const auto validPlugin = [&](PluginIndex plugin) { return plugin == kNoPlugin || plugin < pluginCount; };
+    if (!std::all_of(plugins.begin(), plugins.end(), validPlugin) || !std::all_of(outfitPlugins.begin(), outfitPlugins.end(), validPlugin))
+        return false;
+    const auto listedPlugin = [&](PluginIndex plugin) { return plugin < pluginCount; };
+    if (!std::all_of(m_armorMods.begin(), m_armorMods.end(), listedPlugin) || !std::all_of(m_outfitMods.begin(), m_outfitMods.end(), listedPlugin))
+        return false;
+    const auto rowsBelow = [](const std::vector<Index>& values, std::size_t limit) {
+        return std::all_of(values.begin(), values.end(), [limit](Index row) { return row < limit; });
+    };
+    if (!rowsBelow(m_pluginArmors, rows) || !rowsBelow(m_pluginOutfits, outfitForms.size()))
+        return false;
+    for (const auto& plugin : pluginTable) {
+        if (std::uint64_t(plugin.armorBegin) + plugin.armorCount > m_pluginArmors.size()
+            || std::uint64_t(plugin.outfitBegin) + plugin.outfitCount > m_pluginOutfits.size())
+            return false;
+    }
+
+    for (const auto* index : {&m_trigramIndex, &m_keywordIndex}) {
+        if (index->offsets.size() != index->keys.size() + 1 || index->offsets.back() != index->postings.size()
+            || !std::is_sorted(index->offsets.begin(), index->offsets.end())
+            || std::adjacent_find(index->keys.begin(), index->keys.end(), std::greater_equal<>()) != index->keys.end()
+            || !rowsBelow(index->postings, rows))
+            return false;
+    }
+    return m_slotBitmaps.size() == 32 * m_bitmapWords && m_flagBitmaps.size() == 8 * m_bitmapWords;
+}
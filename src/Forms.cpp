@@ -1,9 +1,12 @@
 #include "Forms.h"
 
+#include <charconv>
+#include <cstring>
+
 namespace Forms {
 
-    bool IsFormString(const std::string &str) {
-        if (str.size() < 4 || str.find("|") == std::string::npos) return false;
+    bool IsFormString(std::string_view str) {
+        if (str.size() < 4 || str.find('|') == std::string_view::npos) return false;
 
         return str.ends_with(".esp") || str.ends_with(".esm") || str.ends_with(".esl") || str.ends_with(".FF");
     }
@@ -18,6 +21,8 @@ namespace Forms {
         return ((obj->formID >> 24 == 0xFE) ? obj->formID & 0x00000FFF : obj->formID & 0x00FFFFFF);
     }
 
+    const RE::TESFile* GetOwningFile(RE::TESForm* obj);
+
     uint32_t GetModIndex(RE::TESForm* obj) {
         if (obj->formID == 0) return 0;
 
@@ -29,178 +34,261 @@ namespace Forms {
     }
 
     std::string GetFormString(RE::TESForm *obj) {
-        if (!obj) {
-            LOG(critical, "GetFormString called with null object");
-            return "0";
-        }
+        return std::string(FormStringCache::GetSingleton().format(obj));
+    }
 
-        std::stringstream ss;
-        uint32_t id = GetBaseID(obj);
+    std::string_view FormStringCache::format(RE::TESForm* form) {
+        std::lock_guard guard(m_lock);
+        checkLoadOrderLocked();
+        return formatLocked(form);
+    }
 
-        // Set hex base ID
-        ss << "0x" << std::hex << id << "|";
+    void FormStringCache::formatAll(std::span<RE::TESForm* const> forms, std::vector<std::string_view>& out) {
+        std::lock_guard guard(m_lock);
+        checkLoadOrderLocked();
+        out.resize(forms.size());
+        for (std::size_t i = 0; i < forms.size(); ++i) {
+            out[i] = formatLocked(forms[i]);
+        }
+    }
 
-        EXTRALOG(info, "GetFormString processing form 0x{:X} ({})", obj->GetFormID(), obj->GetName());
+    void FormStringCache::invalidate() {
+        std::lock_guard guard(m_lock);
+        m_strings.clear();
+        m_blocks.clear();
+        m_blockUsed = kBlockSize;
+    }
 
+    void FormStringCache::checkLoadOrderLocked() {
         const auto Data = RE::TESDataHandler::GetSingleton();
+        if (!Data) return;
+        const std::uint64_t stamp = (static_cast<std::uint64_t>(Data->GetLoadedModCount()) << 32) | Data->GetLoadedLightModCount();
+        if (stamp != m_loadOrderStamp) {
+            m_strings.clear();
+            m_blocks.clear();
+            m_blockUsed = kBlockSize;
+            m_loadOrderStamp = stamp;
+        }
+    }
 
-        if (!Data) {
-            LOG(critical, "Failed to get TESDataHandler singleton");
-            return "0";
+    std::string_view FormStringCache::intern(std::string_view text) {
+        if (text.size() > kBlockSize - m_blockUsed) {
+            m_blocks.push_back(std::make_unique<char[]>(std::max(kBlockSize, text.size())));
+            m_blockUsed = 0;
         }
+        char* dest = m_blocks.back().get() + m_blockUsed;
+        std::memcpy(dest, text.data(), text.size());
+        m_blockUsed += text.size();
+        return {dest, text.size()};
+    }
 
-        // Set Mod name
-        uint32_t index = GetModIndex(obj);
-        EXTRALOG(info, "Form mod index is 0x{:X}", index);
+    std::string_view FormStringCache::formatLocked(RE::TESForm* obj) {
+        if (!obj) {
+            LOG(critical, "GetFormString called with null object");
+            return "0";
+        }
 
-        if (index < 0xFF) {
-            // esp & esm objects
-            RE::TESFile** loadedMods = Data->GetLoadedMods();
-            if (!loadedMods) {
-                LOG(critical, "Failed to get loaded mods array");
-                return "0";
-            }
+        const uint32_t index = GetModIndex(obj);
+        std::uint64_t key = obj->formID;
+        if (index == 0xFF) {
+            // Temporary form IDs get reused for other form types across the session.
+            key |= static_cast<std::uint64_t>(obj->GetFormType()) << 32;
+        }
+        if (auto it = m_strings.find(key); it != m_strings.end())
+            return it->second;
 
-            RE::TESFile *modInfo = loadedMods[index];
+        m_scratch.clear();
+        const uint32_t id = GetBaseID(obj);
+        if (index == 0xFF) {
+            // Temp objects - save form type as part of modname
+            fmt::format_to(std::back_inserter(m_scratch), "0x{:x}|{}.FF", id, static_cast<int>(obj->GetFormType()));
+        } else {
+            const RE::TESFile* modInfo = GetOwningFile(obj);
             if (!modInfo) {
-                LOG(critical, "Null mod info for index {}", index);
+                LOG(critical, "No owning plugin found for form 0x{:X} (mod index 0x{:X})", obj->GetFormID(), index);
                 return "0";
             }
+            fmt::format_to(std::back_inserter(m_scratch), "0x{:x}|{}", id, modInfo->GetFilename());
+        }
+
+        const auto interned = intern(std::string_view(m_scratch.data(), m_scratch.size()));
+        m_strings.emplace(key, interned);
+        return interned;
+    }
+
+    RE::TESForm* ParseFormString(std::string_view objString) {
+        ResolutionContext context;
+        return context.parse(objString);
+    }
+
+    const RE::TESFile* GetOwningFile(RE::TESForm* obj) {
+        const auto Data = RE::TESDataHandler::GetSingleton();
+        if (!obj || !Data) return nullptr;
 
-            ss << modInfo->GetFilename();
-            EXTRALOG(info, "Form belongs to ESP/ESM file: {}", modInfo->GetFilename());
+        uint32_t index = GetModIndex(obj);
+        if (index < 0xFF) {
+            RE::TESFile** loadedMods = Data->GetLoadedMods();
+            return loadedMods ? loadedMods[index] : nullptr;
         }
-        else if (index > 0xFF) {
-            // esl objects
+        if (index > 0xFF) {
             RE::TESFile** loadedCCMods = Data->GetLoadedLightMods();
+            return loadedCCMods ? loadedCCMods[index & 0x00FFF] : nullptr;
+        }
+        return nullptr;
+    }
 
-            if (!loadedCCMods) {
-                LOG(critical, "Failed to get loaded light mods array");
-                return "0";
-            }
+    bool FormReferenceWriter::write(RE::TESForm* form, proto::FormReference* out) {
+        if (!form) return false;
 
-            uint32_t light = index & 0x00FFF;
-            EXTRALOG(info, "Light mod index is 0x{:X}", light);
+        out->set_local_id(GetBaseID(form));
 
-            RE::TESFile *modInfo = loadedCCMods[light];
-            if (!modInfo) {
-                LOG(critical, "Null light mod info for light index {}", light);
-                return "0";
-            }
+        if (GetModIndex(form) == 0xFF) {
+            // Temp objects - save form type instead of a plugin
+            out->set_temporary_form_type(static_cast<uint32_t>(form->GetFormType()));
+            return true;
+        }
 
-            ss << modInfo->GetFilename();
-            EXTRALOG(info, "Form belongs to ESL file: {}", modInfo->GetFilename());
+        const RE::TESFile* file = GetOwningFile(form);
+        if (!file) {
+            LOG(critical, "No owning plugin found for form 0x{:X}", form->GetFormID());
+            return false;
         }
 
-        else {
-            // Temp objects - save form type as part of modname
-            uint8_t formType = static_cast<uint8_t>(obj->GetFormType());
-            ss << static_cast<int>(formType) << ".FF";
-            EXTRALOG(info, "Form is a temporary object with form type {}", formType);
+        auto [it, inserted] = m_indices.try_emplace(file, static_cast<std::uint32_t>(m_files.size()));
+        if (inserted) m_files.push_back(file);
+        out->set_plugin(it->second);
+        return true;
+    }
+
+    void FormReferenceWriter::store(google::protobuf::RepeatedPtrField<proto::PluginEntry>* out) const {
+        out->Reserve(static_cast<int>(m_files.size()));
+        for (const auto* file : m_files) {
+            auto* entry = out->Add();
+            entry->set_name(std::string(file->GetFilename()));
+            entry->set_is_light(file->IsLight());
         }
+    }
 
-        const std::string out = ss.str();
-        //EXTRALOG( "GetFormString result: {}", out);
-        return out;
+    template <class T>
+    bool ParseNumber(std::string_view str, T& out, int base) {
+        auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), out, base);
+        return ec == std::errc() && ptr != str.data();
+    }
+
+    ResolutionContext::ResolutionContext(const google::protobuf::RepeatedPtrField<proto::PluginEntry>& plugins) {
+        m_pluginTable.reserve(plugins.size());
+        for (const auto& plugin : plugins) {
+            bindPlugin(plugin.name(), plugin.is_light());
+        }
+    }
+
+    std::uint32_t ResolutionContext::bindPlugin(std::string_view name, bool isLight) {
+        const auto& resolved = lookupPlugin(name);
+        if (resolved.localMask && (resolved.localMask == 0x00000FFF) != isLight) {
+            LOG(warn, "Plugin {} changed between light and regular since it was saved", name);
+        }
+        m_pluginTable.push_back(resolved);
+        return static_cast<std::uint32_t>(m_pluginTable.size() - 1);
     }
 
-    RE::TESForm* ParseFormString(const std::string &objString) {
-        //EXTRALOG( "ParseFormString called with: {}", objString);
+    const ResolutionContext::ResolvedPlugin& ResolutionContext::lookupPlugin(std::string_view name) {
+        if (auto it = m_pluginsByName.find(name); it != m_pluginsByName.end())
+            return it->second;
 
+        ResolvedPlugin resolved;
+        RE::TESDataHandler* dhand = RE::TESDataHandler::GetSingleton();
+        const RE::TESFile* modInfo = dhand ? dhand->LookupModByName(name) : nullptr;
+        if (!modInfo) {
+            LOG(critical, "Mod not found: {}", name);
+        } else if (modInfo->IsLight()) {
+            // Construct form ID based on whether it's a light mod or not
+            resolved.prefix = 0xFE000000 | (static_cast<uint32_t>(modInfo->GetSmallFileCompileIndex()) << 12);
+            resolved.localMask = 0x00000FFF;
+        } else {
+            resolved.prefix = static_cast<uint32_t>(modInfo->GetCompileIndex()) << 24;
+            resolved.localMask = 0x00FFFFFF;
+        }
+        return m_pluginsByName.try_emplace(std::string(name), resolved).first->second;
+    }
+
+    RE::TESForm* ResolutionContext::parse(std::string_view objString) {
         if (!IsFormString(objString)) {
             LOG(critical, "Invalid form string format: {}", objString);
             return nullptr;
         }
 
         std::size_t pos = objString.find('|');
-        std::string objID = objString.substr(0, pos);
-        //EXTRALOG( "Extracted ID part: {}", objID);
+        std::string_view objID = objString.substr(0, pos);
+        std::string_view mod = objString.substr(pos + 1);
 
         uint32_t baseId = 0;
-        try {
-            if (objID.rfind("0x", 0) == 0) {
-                baseId = std::stoul(objID, nullptr, 16);
-            } else {
-                baseId = std::stoi(objID);
-            }
-            //EXTRALOG( "Parsed base ID: 0x{:X}", baseId);
-        } catch (const std::exception& e) {
-            LOG(critical, "Failed to parse form ID '{}': {}", objID, e.what());
+        bool parsed = (objID.starts_with("0x") || objID.starts_with("0X"))
+            ? ParseNumber(objID.substr(2), baseId, 16)
+            : ParseNumber(objID, baseId, 10);
+        if (!parsed) {
+            LOG(critical, "Failed to parse form ID '{}'", objID);
             return nullptr;
         }
 
-        std::string mod = objString.substr(pos + 1);
-        //EXTRALOG( "Extracted mod part: {}", mod);
-
-        if (objString.ends_with(".FF")) {
-            //EXTRALOG( "Processing temporary form");
+        if (mod.ends_with(".FF")) {
             // Temp objects - check form type
-            mod.resize((mod.length() - 3));
-
-            uint8_t type;
-            try {
-                type = std::stoi(mod, nullptr, 10);
-                //EXTRALOG( "Parsed form type: {}", type);
-            } catch (const std::exception& e) {
-                LOG(critical, "Failed to parse form type '{}': {}", mod, e.what());
+            uint32_t type = 0;
+            if (!ParseNumber(mod.substr(0, mod.size() - 3), type, 10)) {
+                LOG(critical, "Failed to parse form type '{}'", mod);
                 return nullptr;
             }
 
-            uint32_t formId = (static_cast<uint32_t>(0xFF) << 24) | baseId;
-            //EXTRALOG( "Constructed temporary form ID: 0x{:X}", formId);
+            proto::FormReference ref;
+            ref.set_local_id(baseId);
+            ref.set_temporary_form_type(type);
+            return resolve(ref);
+        }
+
+        const auto& plugin = lookupPlugin(mod);
+        if (!plugin.localMask) {
+            return nullptr;
+        }
+
+        uint32_t formId = plugin.prefix | (plugin.localMask == 0x00000FFF ? baseId & 0xFFF : baseId);
+        RE::TESForm* form = formId == 0 ? nullptr : RE::TESForm::LookupByID(formId);
+        if (!form) {
+            LOG(critical, "Form not found with ID 0x{:X}", formId);
+        }
+        return form;
+    }
 
-            RE::TESForm* objform = formId == 0 ? nullptr : RE::TESForm::LookupByID(formId);
+    RE::TESForm* ResolutionContext::resolve(const proto::FormReference& ref) const {
+        uint32_t formId = 0;
+        if (ref.has_temporary_form_type()) {
+            formId = (static_cast<uint32_t>(0xFF) << 24) | ref.local_id();
+            RE::TESForm* objform = RE::TESForm::LookupByID(formId);
             if (!objform) {
                 LOG(critical, "Form not found with ID 0x{:X}", formId);
                 return nullptr;
             }
-
-            uint8_t actualType = static_cast<uint8_t>(objform->GetFormType());
-            //EXTRALOG( "Form found, expected type: {}, actual type: {}", type, actualType);
-
-            if (actualType == type) {
-                //EXTRALOG( "Form type matches, returning form 0x{:X}", formId);
-                return objform;
-            } else {
-                LOG(critical, "Form type mismatch, expected: {}, got: {}", type, actualType);
+            uint32_t actualType = static_cast<uint32_t>(objform->GetFormType());
+            if (actualType != ref.temporary_form_type()) {
+                LOG(critical, "Form type mismatch, expected: {}, got: {}", ref.temporary_form_type(), actualType);
                 return nullptr;
             }
+            return objform;
         }
 
-        //EXTRALOG( "Looking up mod: {}", mod);
-        RE::TESDataHandler* dhand = RE::TESDataHandler::GetSingleton();
-        if (!dhand) {
-            LOG(critical, "Failed to get TESDataHandler singleton");
-            return nullptr;
-        }
+        return resolve(ref.plugin(), ref.local_id());
+    }
 
-        const RE::TESFile* modInfo = dhand->LookupModByName(mod);
-        if (!modInfo) {
-            LOG(critical, "Mod not found: {}", mod);
+    RE::TESForm* ResolutionContext::resolve(std::uint32_t pluginIndex, std::uint32_t localID) const {
+        if (pluginIndex >= m_pluginTable.size() || m_pluginTable[pluginIndex].localMask == 0) {
             return nullptr;
         }
 
-        uint32_t formId = 0;
-        // Construct form ID based on whether it's a light mod or not
-        if (modInfo->IsLight()) {
-            uint16_t smallFileIndex = modInfo->GetSmallFileCompileIndex();
-            //EXTRALOG( "Light mod (ESL), small file index: 0x{:X}", smallFileIndex);
-            formId = 0xFE000000 | (static_cast<uint32_t>(smallFileIndex) << 12) | (baseId & 0xFFF);
-        } else {
-            uint8_t compileIndex = modInfo->GetCompileIndex();
-            //EXTRALOG( "Regular mod (ESP/ESM), compile index: 0x{:X}", compileIndex);
-            formId = (static_cast<uint32_t>(compileIndex) << 24) | baseId;
-        }
-
-        //EXTRALOG(info, "Constructed full form ID: 0x{:X}", formId);
+        const auto& plugin = m_pluginTable[pluginIndex];
+        uint32_t formId = plugin.prefix | (localID & plugin.localMask);
 
         RE::TESForm* form = formId == 0 ? nullptr : RE::TESForm::LookupByID(formId);
         if (!form) {
             LOG(critical, "Form not found with ID 0x{:X}", formId);
-            return nullptr;
         }
-
-        //LOG(info, "Form found: 0x{:X} ({})", formId, form->GetName());
         return form;
     }
 }
\ No newline at end of file
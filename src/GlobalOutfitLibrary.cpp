@@ -0,0 +1,271 @@
+#include "GlobalOutfitLibrary.h"
+
+#include <Windows.h>
+
+#include <algorithm>
+#include <filesystem>
+
+#include "ArmorAddonOverrideService.h"
+#include "Utility.h"
+
+namespace {
+    using iview = std::basic_string_view<char, cobb::char_traits_insensitive>;
+
+    bool InBounds(std::uint64_t offset, std::uint64_t count, std::uint64_t elementSize, std::uint64_t fileSize) {
+        return offset % alignof(std::uint32_t) == 0 && offset + count * elementSize <= fileSize;
+    }
+
+    template <typename T>
+    void Append(std::string& out, const T& value) {
+        out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+}
+
+std::string GlobalOutfitLibrary::GetPath() {
+    return GetRuntimeDirectory() + "Data\\SKSE\\Plugins\\SkyrimOutfitEquipmentSystemNG.library";
+}
+
+std::string GlobalOutfitLibrary::GetPendingPath() {
+    return GetPath() + ".new";
+}
+
+GlobalOutfitLibrary::~GlobalOutfitLibrary() {
+    Close();
+}
+
+void GlobalOutfitLibrary::Close() {
+    if (m_view)
+        UnmapViewOfFile(m_view);
+    if (m_mapping)
+        CloseHandle(m_mapping);
+    if (m_file && m_file != INVALID_HANDLE_VALUE)
+        CloseHandle(m_file);
+    m_view = nullptr;
+    m_mapping = nullptr;
+    m_file = nullptr;
+    m_header = nullptr;
+    m_outfits = nullptr;
+    m_armors = nullptr;
+    m_strings = nullptr;
+}
+
+bool GlobalOutfitLibrary::Open() {
+    if (m_opened)
+        return IsOpen();
+    m_opened = true;
+    if (!Settings::UseGlobalLibrary())
+        return false;
+
+    // The mapped file can't be replaced while the game runs, so exports are staged and swapped in here.
+    const std::filesystem::path path = GetPath();
+    const std::filesystem::path pending = GetPendingPath();
+    std::error_code ec;
+    if (std::filesystem::exists(pending, ec)) {
+        std::filesystem::rename(pending, path, ec);
+        if (ec)
+            LOG(warn, "Failed to apply the pending global outfit library: {}", ec.message());
+        else
+            LOG(info, "Applied the pending global outfit library.");
+    }
+
+    m_file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (m_file == INVALID_HANDLE_VALUE) {
+        LOG(info, "No global outfit library at {}.", GetPath());
+        Close();
+        return false;
+    }
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(m_file, &fileSize) || fileSize.QuadPart < static_cast<LONGLONG>(sizeof(FileHeader))
+        || fileSize.QuadPart > std::numeric_limits<std::uint32_t>::max()) {
+        LOG(warn, "The global outfit library has an invalid size.");
+        Close();
+        return false;
+    }
+    m_mapping = CreateFileMappingW(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    m_view = m_mapping ? static_cast<const std::byte*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+    if (!m_view) {
+        LOG(warn, "Failed to map the global outfit library.");
+        Close();
+        return false;
+    }
+    if (!Validate(static_cast<std::size_t>(fileSize.QuadPart))) {
+        LOG(warn, "The global outfit library is corrupt or from an unsupported version; ignoring it.");
+        Close();
+        return false;
+    }
+
+    m_sorted = true;
+    for (std::size_t i = 1; i < size() && m_sorted; ++i) {
+        const auto previous = name(i - 1);
+        const auto current = name(i);
+        m_sorted = iview(previous.data(), previous.size()).compare(iview(current.data(), current.size())) < 0;
+    }
+    if (!m_sorted)
+        LOG(info, "The global outfit library isn't in the current name order; exporting it again will speed up lookups.");
+
+    const auto* plugins = reinterpret_cast<const PluginRecord*>(m_view + m_header->pluginsOffset);
+    for (std::uint32_t i = 0; i < m_header->pluginCount; ++i) {
+        m_forms.bindPlugin(std::string_view(m_strings + plugins[i].nameOffset, plugins[i].nameLength), plugins[i].isLight != 0);
+    }
+    LOG(info, "Mapped the global outfit library with {} outfits.", m_header->outfitCount);
+    return true;
+}
+
+bool GlobalOutfitLibrary::Validate(std::size_t fileSize) {
+    const auto* header = reinterpret_cast<const FileHeader*>(m_view);
+    if (header->magic != kMagic || header->version != kVersion || header->fileSize != fileSize)
+        return false;
+    if (!InBounds(header->pluginsOffset, header->pluginCount, sizeof(PluginRecord), fileSize)
+        || !InBounds(header->outfitsOffset, header->outfitCount, sizeof(OutfitRecord), fileSize)
+        || !InBounds(header->armorsOffset, header->armorCount, sizeof(ArmorRecord), fileSize)
+        || std::uint64_t(header->stringsOffset) + header->stringsSize > fileSize)
+        return false;
+
+    const auto* plugins = reinterpret_cast<const PluginRecord*>(m_view + header->pluginsOffset);
+    for (std::uint32_t i = 0; i < header->pluginCount; ++i) {
+        if (std::uint64_t(plugins[i].nameOffset) + plugins[i].nameLength > header->stringsSize)
+            return false;
+    }
+    const auto* outfits = reinterpret_cast<const OutfitRecord*>(m_view + header->outfitsOffset);
+    for (std::uint32_t i = 0; i < header->outfitCount; ++i) {
+        if (std::uint64_t(outfits[i].nameOffset) + outfits[i].nameLength > header->stringsSize
+            || std::uint64_t(outfits[i].firstArmor) + outfits[i].armorCount > header->armorCount)
+            return false;
+    }
+    const auto* armors = reinterpret_cast<const ArmorRecord*>(m_view + header->armorsOffset);
+    for (std::uint32_t i = 0; i < header->armorCount; ++i) {
+        if (armors[i].plugin >= header->pluginCount)
+            return false;
+    }
+
+    m_header = header;
+    m_outfits = outfits;
+    m_armors = armors;
+    m_strings = reinterpret_cast<const char*>(m_view + header->stringsOffset);
+    return true;
+}
+
+std::string_view GlobalOutfitLibrary::name(std::size_t index) const {
+    const auto& record = m_outfits[index];
+    return {m_strings + record.nameOffset, record.nameLength};
+}
+
+bool GlobalOutfitLibrary::isFavorite(std::size_t index) const {
+    return (m_outfits[index].flags & OutfitRecord::kFavorite) != 0;
+}
+
+std::optional<std::size_t> GlobalOutfitLibrary::find(std::string_view outfitName) const {
+    const iview key(outfitName.data(), outfitName.size());
+    if (!m_sorted) {
+        for (std::size_t i = 0; i < size(); ++i) {
+            const auto candidate = name(i);
+            if (iview(candidate.data(), candidate.size()).compare(key) == 0)
+                return i;
+        }
+        return std::nullopt;
+    }
+    std::size_t low = 0;
+    std::size_t high = size();
+    while (low < high) {
+        const auto mid = low + (high - low) / 2;
+        const auto candidate = name(mid);
+        const int order = iview(candidate.data(), candidate.size()).compare(key);
+        if (order == 0)
+            return mid;
+        if (order < 0)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    return std::nullopt;
+}
+
+void GlobalOutfitLibrary::readArmors(std::size_t index, std::unordered_set<RE::TESObjectARMO*>& out) const {
+    const auto& record = m_outfits[index];
+    out.reserve(out.size() + record.armorCount);
+    for (std::uint32_t i = 0; i < record.armorCount; ++i) {
+        const auto& armorRecord = m_armors[record.firstArmor + i];
+        auto* armor = skyrim_cast<RE::TESObjectARMO*>(m_forms.resolve(armorRecord.plugin, armorRecord.localID));
+        if (armor)
+            out.insert(armor);
+    }
+}
+
+bool GlobalOutfitLibrary::matches(std::size_t index, const Outfit& outfit) const {
+    if (outfit.m_armors.size() > m_outfits[index].armorCount)
+        return false;
+    std::unordered_set<RE::TESObjectARMO*> armors;
+    readArmors(index, armors);
+    return armors == outfit.m_armors;
+}
+
+std::string GlobalOutfitLibrary::Build(ArmorAddonOverrideService& service) {
+    Forms::FormReferenceWriter refs;
+    std::vector<OutfitRecord> outfits;
+    std::vector<ArmorRecord> armors;
+    std::string strings;
+    outfits.reserve(service.outfits.size());
+
+    // find() binary searches in case-insensitive order, which isn't the order the service lists outfits in.
+    std::vector<OutfitMap::value_type*> entries;
+    entries.reserve(service.outfits.size());
+    for (auto& entry : service.outfits)
+        entries.push_back(&entry);
+    std::sort(entries.begin(), entries.end(), [](const auto* a, const auto* b) { return a->first < b->first; });
+    for (auto* entry : entries) {
+        auto& outfit = ArmorAddonOverrideService::materialize(entry->second);
+        OutfitRecord record{};
+        record.nameOffset = static_cast<std::uint32_t>(strings.size());
+        record.nameLength = static_cast<std::uint16_t>(outfit.m_name.size());
+        record.flags = outfit.m_favorited ? OutfitRecord::kFavorite : 0;
+        record.firstArmor = static_cast<std::uint32_t>(armors.size());
+        strings.append(outfit.m_name);
+        for (auto* armor : outfit.m_armors) {
+            proto::FormReference ref;
+            // Runtime-created forms only exist in one save, so they can't be shared.
+            if (!armor || !refs.write(armor, &ref) || ref.has_temporary_form_type())
+                continue;
+            armors.push_back({ref.plugin(), ref.local_id()});
+        }
+        record.armorCount = static_cast<std::uint32_t>(armors.size()) - record.firstArmor;
+        outfits.push_back(record);
+    }
+
+    google::protobuf::RepeatedPtrField<proto::PluginEntry> pluginEntries;
+    refs.store(&pluginEntries);
+    std::vector<PluginRecord> plugins;
+    plugins.reserve(pluginEntries.size());
+    for (const auto& plugin : pluginEntries) {
+        PluginRecord record{};
+        record.nameOffset = static_cast<std::uint32_t>(strings.size());
+        record.nameLength = static_cast<std::uint16_t>(plugin.name().size());
+        record.isLight = plugin.is_light() ? 1 : 0;
+        strings.append(plugin.name());
+        plugins.push_back(record);
+    }
+
+    FileHeader header{};
+    header.magic = kMagic;
+    header.version = kVersion;
+    header.pluginCount = static_cast<std::uint32_t>(plugins.size());
+    header.outfitCount = static_cast<std::uint32_t>(outfits.size());
+    header.armorCount = static_cast<std::uint32_t>(armors.size());
+    header.pluginsOffset = sizeof(FileHeader);
+    header.outfitsOffset = header.pluginsOffset + header.pluginCount * sizeof(PluginRecord);
+    header.armorsOffset = header.outfitsOffset + header.outfitCount * sizeof(OutfitRecord);
+    header.stringsOffset = header.armorsOffset + header.armorCount * sizeof(ArmorRecord);
+    header.stringsSize = static_cast<std::uint32_t>(strings.size());
+    header.fileSize = header.stringsOffset + header.stringsSize;
+
+    std::string out;
+    out.reserve(header.fileSize);
+    Append(out, header);
+    for (const auto& plugin : plugins)
+        Append(out, plugin);
+    for (const auto& outfit : outfits)
+        Append(out, outfit);
+    for (const auto& armor : armors)
+        Append(out, armor);
+    out.append(strings);
+    return out;
+}
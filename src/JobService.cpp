@@ -0,0 +1,83 @@
+#include "JobService.h"
+
+#include <algorithm>
+#include <thread>
+
+#include "Utility.h"
+
+void JobService::Job::finish(bool succeeded, std::int32_t result) {
+    if (m_status.load() != Status::kRunning)
+        return;
+    // Stored first, so whoever sees the job finished also sees its result.
+    m_result = result;
+    auto expected = Status::kRunning;
+    if (!m_status.compare_exchange_strong(expected, succeeded ? Status::kSucceeded : Status::kFailed))
+        return;
+    LOG(info, "Job {} ({}) {}.", m_id, m_kind, succeeded ? "succeeded" : "failed");
+    // Mod events have to be sent from the main thread.
+    SKSE::GetTaskInterface()->AddTask([id = m_id, kind = m_kind]() {
+        SKSE::ModCallbackEvent event{kFinishedEvent, kind.c_str(), static_cast<float>(id), nullptr};
+        SKSE::GetModCallbackEventSource()->SendEvent(&event);
+    });
+}
+
+std::shared_ptr<JobService::Job> JobService::Start(std::string kind, Work work) {
+    auto job = std::make_shared<Job>();
+    job->m_kind = std::move(kind);
+    {
+        std::lock_guard guard(m_lock);
+        job->m_id = m_nextID++;
+        if (m_nextID <= kNoJob)
+            m_nextID = kNoJob + 1;
+        if (m_jobs.size() >= kMaxJobs) {
+            // Forget the oldest finished job; running ones stay reachable however many there are.
+            const auto finished = std::find_if(m_jobs.begin(), m_jobs.end(), [](const auto& entry) {
+                return entry->m_status.load() != Status::kRunning;
+            });
+            if (finished != m_jobs.end())
+                m_jobs.erase(finished);
+        }
+        m_jobs.push_back(job);
+    }
+    LOG(info, "Started job {} ({}).", job->m_id, job->m_kind);
+    std::thread([job, work = std::move(work)]() {
+        try {
+            work(job);
+        } catch (const std::exception& e) {
+            LOG(critical, "Job {} ({}) threw: {}", job->m_id, job->m_kind, e.what());
+            job->finish(false);
+        }
+    }).detach();
+    return job;
+}
+
+std::shared_ptr<JobService::Job> JobService::Find(JobID id) const {
+    std::lock_guard guard(m_lock);
+    for (const auto& job : m_jobs) {
+        if (job->m_id == id)
+            return job;
+    }
+    return nullptr;
+}
+
+JobService::Status JobService::GetStatus(JobID id) const {
+    const auto job = Find(id);
+    return job ? job->m_status.load() : Status::kUnknown;
+}
+
+float JobService::GetProgress(JobID id) const {
+    const auto job = Find(id);
+    if (!job)
+        return 0.0f;
+    if (job->m_status.load() != Status::kRunning)
+        return 1.0f;
+    const auto total = job->m_total.load();
+    if (total == 0)
+        return 0.0f;
+    return std::min(1.0f, static_cast<float>(job->m_done.load()) / static_cast<float>(total));
+}
+
+std::int32_t JobService::GetResult(JobID id) const {
+    const auto job = Find(id);
+    return job ? job->m_result.load() : 0;
+}
@@ -1,8 +1,10 @@
 #include <Windows.h>
+#include <google/protobuf/arena.h>
 #include <google/protobuf/json/json.h>
 #include <google/protobuf/util/json_util.h>
 
 #include "ArmorAddonOverrideService.h"
+#include "ArmorCatalog.h"
 #include "AutoOutfitSwitchService.h"
 #include "Hooking.h"
 #include "OutfitSystem.h"
@@ -99,17 +101,24 @@ void Callback_Messaging_SKSE(SKSE::MessagingInterface::Message* message) {
 
     } else if (message->type == SKSE::MessagingInterface::kPostPostLoad) {
     } else if (message->type == SKSE::MessagingInterface::kDataLoaded) {
+        // Form tables are final from here on, but plugins handling this message after us still rename armors and add
+        // keywords. Tasks run once every handler has returned; the catalog reads the forms then and indexes them off
+        // the main thread before the MCM first asks.
+        SKSE::GetTaskInterface()->AddTask([]() { ArmorCatalog::BuildAsync(); });
     } else if (message->type == SKSE::MessagingInterface::kNewGame) {
         Game_Full_Load_Initialize_Callback();
 
         auto pc = RE::PlayerCharacter::GetSingleton();
         ArmorAddonOverrideService::GetInstance().addActor(pc);
+        ArmorAddonOverrideService::GetInstance().attachGlobalLibrary();
 
         AutoOutfitSwitchService::GetSingleton().Initialize();
     } else if (message->type == SKSE::MessagingInterface::kPreLoadGame) {
         Game_Full_Load_Initialize_Callback();
     }
     else if (message->type == SKSE::MessagingInterface::kPostLoadGame) {
+        // The library itself is only mapped once per session; this just lists what the save doesn't override.
+        ArmorAddonOverrideService::GetInstance().attachGlobalLibrary();
         AutoOutfitSwitchService::GetSingleton().Initialize();
     }
 }
@@ -120,13 +129,29 @@ void _assertRead(bool result, const char* err);
 void Callback_Serialization_Save(SKSE::SerializationInterface* intfc) {
     LOG(info, "Writing savedata...");
     //
-    if (intfc->OpenRecord(ArmorAddonOverrideService::signature, ArmorAddonOverrideService::kSaveVersionV1)) {
+    if (intfc->OpenRecord(ArmorAddonOverrideService::signature, ArmorAddonOverrideService::kSaveVersionV3)) {
         try {
             auto& service = ArmorAddonOverrideService::GetInstance();
-            const auto& data = service.save();
+            const auto& data = service.saveSettings();
             const auto& data_ser = data.SerializeAsString();
             _assertWrite(intfc->WriteRecordData(data_ser.data(), static_cast<std::uint32_t>(data_ser.size())),
                          "Failed to write proto into SKSE record.");
+
+            // Unchanged chunks come straight from the service's cache of the previous save.
+            std::vector<std::string_view> chunks;
+            service.saveOutfitChunks(chunks);
+            for (const auto& chunk : chunks) {
+                _assertWrite(intfc->OpenRecord(ArmorAddonOverrideService::outfitChunkSignature, ArmorAddonOverrideService::kSaveVersionV3),
+                             "Failed to open outfit chunk record.");
+                _assertWrite(intfc->WriteRecordData(chunk.data(), static_cast<std::uint32_t>(chunk.size())),
+                             "Failed to write outfit chunk into SKSE record.");
+            }
+
+            const auto assignments = service.saveAssignments();
+            _assertWrite(intfc->OpenRecord(ArmorAddonOverrideService::assignmentsSignature, ArmorAddonOverrideService::kSaveVersionV3),
+                         "Failed to open assignments record.");
+            _assertWrite(intfc->WriteRecordData(assignments.data(), static_cast<std::uint32_t>(assignments.size())),
+                         "Failed to write assignments into SKSE record.");
         } catch (const ArmorAddonOverrideService::save_error& exception) {
             LOG(info, "Save FAILED for ArmorAddonOverrideService.");
             LOG(info, " - Exception string: %s", exception.what());
@@ -156,6 +181,31 @@ void Callback_Serialization_Save(SKSE::SerializationInterface* intfc) {
     LOG(info, "Saving done!");
 }
 
+namespace {
+    // Record bytes are read into this buffer and parsed in place. It is kept between loads so that reloading a
+    // save with a large outfit library doesn't reallocate (and zero-fill) a fresh buffer every time.
+    std::vector<char> g_recordBuffer;
+
+    // Messages parsed from a record are allocated on an arena, so the whole tree of outfits and assignments is
+    // freed in one go once the services have copied what they need out of it.
+    constexpr std::size_t kArenaInitialBlockSize = 64 * 1024;
+
+    std::span<const char> ReadRecordIntoBuffer(SKSE::SerializationInterface* intfc, std::uint32_t length) {
+        if (g_recordBuffer.size() < length) {
+            g_recordBuffer.resize(length);
+        }
+        _assertRead(intfc->ReadRecordData(g_recordBuffer.data(), length) == length, "Failed to load protobuf.");
+        return {g_recordBuffer.data(), length};
+    }
+
+    google::protobuf::ArenaOptions RecordArenaOptions(std::uint32_t length) {
+        google::protobuf::ArenaOptions options;
+        // Parsed messages are usually a few times larger than their wire form.
+        options.start_block_size = std::max<std::size_t>(kArenaInitialBlockSize, std::size_t(length) * 2);
+        return options;
+    }
+}
+
 void Callback_Serialization_Load(SKSE::SerializationInterface* intfc) {
     LOG(info, "Loading savedata...");
     //
@@ -171,18 +221,19 @@ void Callback_Serialization_Load(SKSE::SerializationInterface* intfc) {
                 try {
                     auto& service = ArmorAddonOverrideService::GetInstance();
                     if (version >= ArmorAddonOverrideService::kSaveVersionV1) {
+                        // v1 and v2 share the same message; the service reads whichever form fields are present.
+                        // v3 only stores the settings here and is followed by chunk records.
                         // Read data from protobuf.
-                        std::vector<char> buf;
-                        buf.insert(buf.begin(), length, 0);
-                        _assertRead(intfc->ReadRecordData(buf.data(), length) == length, "Failed to load protobuf.");
+                        auto buf = ReadRecordIntoBuffer(intfc, length);
 
                         // Parse data in protobuf.
-                        proto::OutfitSystem data;
-                        _assertRead(data.ParseFromArray(buf.data(), static_cast<int>(buf.size())),
+                        google::protobuf::Arena arena(RecordArenaOptions(length));
+                        auto* data = google::protobuf::Arena::Create<proto::OutfitSystem>(&arena);
+                        _assertRead(data->ParseFromArray(buf.data(), static_cast<int>(buf.size())),
                                     "Failed to parse protobuf.");
 
                         // Load data from protobuf struct.
-                        service = ArmorAddonOverrideService(data, intfc);
+                        service = ArmorAddonOverrideService(*data, intfc);
                         LOG(info, "Succesfully loaded protobuf data for ArmorAddonOverrideService.");
                     } else {
                         LOG(err, "Legacy format not supported. Try upgrading first.");
@@ -192,24 +243,42 @@ void Callback_Serialization_Load(SKSE::SerializationInterface* intfc) {
                     LOG(info, " - Exception string: %s", exception.what());
                 }
                 break;
+            case ArmorAddonOverrideService::outfitChunkSignature:
+            case ArmorAddonOverrideService::assignmentsSignature:
+                try {
+                    auto& service = ArmorAddonOverrideService::GetInstance();
+                    auto buf = ReadRecordIntoBuffer(intfc, length);
+
+                    google::protobuf::Arena arena(RecordArenaOptions(length));
+                    auto* data = google::protobuf::Arena::Create<proto::OutfitSystemChunk>(&arena);
+                    _assertRead(data->ParseFromArray(buf.data(), static_cast<int>(buf.size())),
+                                "Failed to parse protobuf.");
+
+                    // Chunks are written after the settings record, so they merge into the service it created.
+                    service.loadChunk(*data, buf);
+                    if (Settings::ExtraLoggingEnabled()) EXTRALOG(info, " Chunk: {}.", ProtoUtils::readMessageAsJSON(*data));
+                } catch (const ArmorAddonOverrideService::load_error& exception) {
+                    LOG(info, "Load FAILED for ArmorAddonOverrideService chunk.");
+                    LOG(info, " - Exception string: %s", exception.what());
+                }
+                break;
             case OutfitSystemCacheService::signature:
                 try {
                     auto& service = OutfitSystemCacheService::GetSingleton();
                     if (version >= OutfitSystemCacheService::kSaveVersionV1) {
                         // Read data from protobuf.
-                        std::vector<char> buf;
-                        buf.insert(buf.begin(), length, 0);
-                        _assertRead(intfc->ReadRecordData(buf.data(), length) == length, "Failed to load protobuf.");
+                        auto buf = ReadRecordIntoBuffer(intfc, length);
 
                         // Parse data in protobuf.
-                        proto::OutfitSystemCache data;
-                        _assertRead(data.ParseFromArray(buf.data(), static_cast<int>(buf.size())),
+                        google::protobuf::Arena arena(RecordArenaOptions(length));
+                        auto* data = google::protobuf::Arena::Create<proto::OutfitSystemCache>(&arena);
+                        _assertRead(data->ParseFromArray(buf.data(), static_cast<int>(buf.size())),
                                     "Failed to parse protobuf.");
 
                         // Load data from protobuf struct.
-                        service = OutfitSystemCacheService(data);
+                        service = OutfitSystemCacheService(*data);
                         LOG(info, "Succesfully loaded protobuf data for OutfitSystemCacheService.");
-                        if (Settings::ExtraLoggingEnabled()) EXTRALOG(info, " Data: {}.", ProtoUtils::readMessageAsJSON(data));
+                        if (Settings::ExtraLoggingEnabled()) EXTRALOG(info, " Data: {}.", ProtoUtils::readMessageAsJSON(*data));
                     } else {
                         LOG(err, "Legacy format not supported. Try upgrading first.");
                     }
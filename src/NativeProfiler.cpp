@@ -0,0 +1,167 @@
+#include "NativeProfiler.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+    // Bucket 0 holds calls under a microsecond; bucket b holds [2^(b-1), 2^b) microseconds, the last one everything
+    // from about four seconds up.
+    constexpr std::size_t kBuckets = 24;
+
+    // Only the owning thread writes these, so plain loads and stores suffice; they're atomic only so the dump can read
+    // them while the owner keeps going.
+    struct Counters {
+        std::string_view name;
+        std::atomic<std::uint64_t> calls{0};
+        std::atomic<std::uint64_t> totalNanoseconds{0};
+        std::atomic<std::uint64_t> maxNanoseconds{0};
+        std::array<std::atomic<std::uint32_t>, kBuckets> histogram{};
+
+        void add(std::atomic<std::uint64_t>& counter, std::uint64_t value) noexcept {
+            counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+        }
+    };
+
+    struct ThreadCounters {
+        std::mutex lock;              // guards counters against the dump while a name is added; never taken to count
+        std::deque<Counters> counters;// a deque, so adding a name doesn't move the others
+        std::unordered_map<const char*, Counters*> byName;// only the owning thread uses this
+    };
+
+    // Thread tables outlive their threads, so nothing recorded is lost when a thread exits.
+    std::mutex g_threadsLock;
+    std::vector<std::unique_ptr<ThreadCounters>> g_threads;
+
+    ThreadCounters& CurrentThread() {
+        thread_local ThreadCounters* current = []() {
+            std::lock_guard guard(g_threadsLock);
+            return g_threads.emplace_back(std::make_unique<ThreadCounters>()).get();
+        }();
+        return *current;
+    }
+
+    struct Totals {
+        std::string_view name;
+        std::uint64_t calls = 0;
+        std::uint64_t totalNanoseconds = 0;
+        std::uint64_t maxNanoseconds = 0;
+        std::array<std::uint64_t, kBuckets> histogram{};
+    };
+}
+
+void NativeProfiler::Record(std::string_view name, std::chrono::steady_clock::duration elapsed) noexcept {
+    auto& thread = CurrentThread();
+    Counters* counters;
+    if (const auto it = thread.byName.find(name.data()); it != thread.byName.end()) {
+        counters = it->second;
+    } else {
+        try {
+            std::lock_guard guard(thread.lock);
+            counters = &thread.counters.emplace_back();
+            counters->name = name;
+            thread.byName.emplace(name.data(), counters);
+        } catch (...) {
+            return;
+        }
+    }
+
+    const auto nanoseconds = static_cast<std::uint64_t>(std::max<std::int64_t>(0, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+    const auto bucket = std::min<std::size_t>(std::bit_width(nanoseconds / 1000), kBuckets - 1);
+    counters->add(counters->calls, 1);
+    counters->add(counters->totalNanoseconds, nanoseconds);
+    if (nanoseconds > counters->maxNanoseconds.load(std::memory_order_relaxed))
+        counters->maxNanoseconds.store(nanoseconds, std::memory_order_relaxed);
+    auto& slot = counters->histogram[bucket];
+    slot.store(slot.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+std::size_t NativeProfiler::Dump() {
+    // The same name can have a different address in each translation unit, so threads are merged by its text.
+    std::unordered_map<std::string_view, Totals> byName;
+    {
+        std::lock_guard threadsGuard(g_threadsLock);
+        for (const auto& thread : g_threads) {
+            std::lock_guard guard(thread->lock);
+            for (const auto& counters : thread->counters) {
+                auto& totals = byName[counters.name];
+                totals.name = counters.name;
+                totals.calls += counters.calls.load(std::memory_order_relaxed);
+                totals.totalNanoseconds += counters.totalNanoseconds.load(std::memory_order_relaxed);
+                totals.maxNanoseconds = std::max(totals.maxNanoseconds, counters.maxNanoseconds.load(std::memory_order_relaxed));
+                for (std::size_t i = 0; i < kBuckets; ++i)
+                    totals.histogram[i] += counters.histogram[i].load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    std::vector<Totals> report;
+    report.reserve(byName.size());
+    for (auto& [name, totals] : byName) {
+        if (totals.calls)
+            report.push_back(totals);
+    }
+    std::sort(report.begin(), report.end(), [](const Totals& a, const Totals& b) {
+        if (a.totalNanoseconds != b.totalNanoseconds)
+            return a.totalNanoseconds > b.totalNanoseconds;
+        return a.name < b.name;
+    });
+
+    std::vector<std::string> lines;
+    lines.reserve(report.size() + 2);
+    lines.push_back(fmt::format("Native profile: {} natives", report.size()));
+    lines.push_back(fmt::format("{:<48} {:>10} {:>12} {:>10} {:>10}  histogram (calls per log2 us bucket: <1, <2, <4, ...)",
+                                "native", "calls", "total ms", "mean us", "max us"));
+    for (const auto& totals : report) {
+        std::string histogram;
+        const auto last = std::find_if(totals.histogram.rbegin(), totals.histogram.rend(), [](auto count) { return count != 0; });
+        const auto used = static_cast<std::size_t>(totals.histogram.rend() - last);
+        for (std::size_t i = 0; i < used; ++i) {
+            if (i)
+                histogram += ' ';
+            histogram += std::to_string(totals.histogram[i]);
+        }
+        lines.push_back(fmt::format("{:<48} {:>10} {:>12.3f} {:>10.1f} {:>10.1f}  {}",
+                                    totals.name,
+                                    totals.calls,
+                                    totals.totalNanoseconds / 1e6,
+                                    totals.totalNanoseconds / 1e3 / totals.calls,
+                                    totals.maxNanoseconds / 1e3,
+                                    histogram));
+    }
+
+    // Dumps are asked for explicitly, so they're written even with logging turned off.
+    for (const auto& line : lines)
+        FORCELOG(info, "{}", line);
+    // The console may only be written from the main thread. It keeps its history while closed, so a dump asked for
+    // from a script can still be read there later.
+    SKSE::GetTaskInterface()->AddTask([lines = std::move(lines)]() {
+        auto* console = RE::ConsoleLog::GetSingleton();
+        if (!console)
+            return;
+        for (const auto& line : lines)
+            console->Print("%s", line.c_str());
+    });
+    return report.size();
+}
+
+void NativeProfiler::Reset() {
+    std::lock_guard threadsGuard(g_threadsLock);
+    for (const auto& thread : g_threads) {
+        std::lock_guard guard(thread->lock);
+        for (auto& counters : thread->counters) {
+            counters.calls.store(0, std::memory_order_relaxed);
+            counters.totalNanoseconds.store(0, std::memory_order_relaxed);
+            counters.maxNanoseconds.store(0, std::memory_order_relaxed);
+            for (auto& count : counters.histogram)
+                count.store(0, std::memory_order_relaxed);
+        }
+    }
+}
@@ -0,0 +1,186 @@
+#include "OutfitLibrary.h"
+
+#include <filesystem>
+#include <fstream>
+
+#include "ArmorAddonOverrideService.h"
+#include "Forms.h"
+#include "Utility.h"
+
+namespace OutfitLibrary {
+    namespace {
+        bool ReadFile(const std::filesystem::path& path, std::string& out) {
+            std::ifstream file(path, std::ios::binary | std::ios::ate);
+            if (!file)
+                return false;
+            out.resize(static_cast<std::size_t>(file.tellg()));
+            file.seekg(0);
+            file.read(out.data(), static_cast<std::streamsize>(out.size()));
+            return file.good();
+        }
+
+        bool WriteFile(const std::filesystem::path& path, const std::string& data) {
+            std::ofstream file(path, std::ios::binary | std::ios::trunc);
+            if (!file)
+                return false;
+            file.write(data.data(), static_cast<std::streamsize>(data.size()));
+            return file.good();
+        }
+
+        // Index entries come from a user-editable directory; never let one point outside of it.
+        bool IsPlainFileName(const std::string& name) {
+            return !name.empty() && name.find_first_of("\\/:") == std::string::npos && name != "." && name != "..";
+        }
+
+        std::uint32_t ComputeSlotMask(const Outfit& outfit) {
+            std::uint32_t mask = 0;
+            for (const auto* armor : outfit.m_armors) {
+                if (armor)
+                    mask |= static_cast<std::uint32_t>(armor->GetSlotMask());
+            }
+            return mask;
+        }
+    }
+
+    std::string GetDirectory() {
+        return GetRuntimeDirectory() + "Data\\SKSE\\Plugins\\OutfitEquipmentSystemNGLibrary\\";
+    }
+
+    std::string GetIndexPath() {
+        return GetDirectory() + "index.bin";
+    }
+
+    std::string GetOutfitFileName(const std::string& name) {
+        std::uint64_t hash = 0xcbf29ce484222325ull;
+        for (unsigned char c : name) {
+            if (c >= 'A' && c <= 'Z')
+                c = static_cast<unsigned char>(c - 'A' + 'a');
+            hash = (hash ^ c) * 0x100000001b3ull;
+        }
+        return fmt::format("{:016x}.outfit", hash);
+    }
+
+    bool LoadOutfitBody(Outfit& outfit) {
+        // Whatever happens, the outfit stops being pending: a file that can't be read now won't be readable on the
+        // next lookup either, and the equip hook looks outfits up constantly.
+        const auto fileName = std::move(outfit.m_libraryFile);
+        outfit.m_libraryFile.clear();
+        if (!IsPlainFileName(fileName)) {
+            LOG(warn, "Outfit {} references an invalid library file {}.", outfit.m_name, fileName);
+            return false;
+        }
+        std::string buffer;
+        if (!ReadFile(GetDirectory() + fileName, buffer)) {
+            LOG(warn, "Failed to read library file {} for outfit {}.", fileName, outfit.m_name);
+            return false;
+        }
+        proto::OutfitSystemChunk chunk;
+        if (!chunk.ParseFromString(buffer) || chunk.outfits_size() != 1) {
+            LOG(warn, "Library file {} for outfit {} is corrupt.", fileName, outfit.m_name);
+            return false;
+        }
+        Forms::ResolutionContext forms(chunk.plugins());
+        Outfit body(chunk.outfits(0), forms);
+        outfit.m_armors = std::move(body.m_armors);
+        EXTRALOG(info, "Read outfit {} from the outfit library.", outfit.m_name);
+        return true;
+    }
+
+    bool ReadIndex(proto::OutfitLibraryIndex& index) {
+        std::string buffer;
+        if (!ReadFile(GetIndexPath(), buffer) || !index.ParseFromString(buffer)) {
+            LOG(warn, "Failed to read the outfit library index.");
+            return false;
+        }
+        if (index.version() > kIndexVersion) {
+            LOG(warn, "Outfit library index version {} is newer than supported ({}).", index.version(), kIndexVersion);
+            return false;
+        }
+        return true;
+    }
+
+    std::int32_t ImportIndex(ArmorAddonOverrideService& service, const proto::OutfitLibraryIndex& index) {
+        std::int32_t added = 0;
+        for (const auto& entry : index.outfits()) {
+            if (!IsPlainFileName(entry.file()) || service.hasOutfit(entry.name().c_str()))
+                continue;
+            try {
+                ArmorAddonOverrideService::_validateNameOrThrow(entry.name().c_str());
+            } catch (const ArmorAddonOverrideService::bad_name&) {
+                continue;
+            }
+            auto& created = *service.outfits.emplace(cobb::istring(entry.name().data(), entry.name().size()), entry.name().c_str()).first;
+            service.outfits.setFavorite(created, entry.is_favorite());
+            created.second.m_libraryFile = entry.file();
+            ++added;
+        }
+        LOG(info, "Imported {} outfits from the outfit library index.", added);
+        return added;
+    }
+
+    ExportData BuildExport(ArmorAddonOverrideService& service) {
+        ExportData data;
+        data.index.set_version(kIndexVersion);
+        data.files.reserve(service.outfits.size());
+        for (auto& entry : service.outfits) {
+            auto& outfit = ArmorAddonOverrideService::materialize(entry.second);
+            proto::OutfitSystemChunk chunk;
+            Forms::FormReferenceWriter refs;
+            *chunk.add_outfits() = outfit.save(refs);
+            refs.store(chunk.mutable_plugins());
+
+            auto fileName = GetOutfitFileName(outfit.m_name);
+            auto* indexEntry = data.index.add_outfits();
+            indexEntry->set_name(outfit.m_name);
+            indexEntry->set_file(fileName);
+            indexEntry->set_is_favorite(outfit.m_favorited);
+            indexEntry->set_slot_mask(ComputeSlotMask(outfit));
+            data.files.emplace_back(std::move(fileName), chunk.SerializeAsString());
+        }
+        return data;
+    }
+
+    bool WriteExport(const ExportData& data, std::string& error) {
+        // Build the new library next to the old one and swap the directories at the end, so a failed export leaves
+        // the previous library intact.
+        const std::filesystem::path target = GetDirectory();
+        const std::filesystem::path staging = target.parent_path().string() + ".tmp";
+        const std::filesystem::path previous = target.parent_path().string() + ".old";
+        std::error_code ec;
+        std::filesystem::remove_all(staging, ec);
+        std::filesystem::create_directories(staging, ec);
+        if (ec) {
+            error = "Failed to create the outfit library directory";
+            return false;
+        }
+        for (const auto& [fileName, contents] : data.files) {
+            if (!WriteFile(staging / fileName, contents)) {
+                error = "Failed to write outfit library file " + fileName;
+                return false;
+            }
+        }
+        if (!WriteFile(staging / "index.bin", data.index.SerializeAsString())) {
+            error = "Failed to write the outfit library index";
+            return false;
+        }
+
+        std::filesystem::remove_all(previous, ec);
+        if (std::filesystem::exists(target.parent_path(), ec)) {
+            std::filesystem::rename(target.parent_path(), previous, ec);
+            if (ec) {
+                error = "Failed to replace the outfit library";
+                return false;
+            }
+        }
+        std::filesystem::rename(staging, target.parent_path(), ec);
+        if (ec) {
+            // Put the old library back rather than leaving none at all.
+            std::error_code restoreError;
+            std::filesystem::rename(previous, target.parent_path(), restoreError);
+            error = "Failed to replace the outfit library";
+            return false;
+        }
+        std::filesystem::remove_all(previous, ec);
+        return true;
+    }
+}
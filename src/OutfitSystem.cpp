@@ -3,8 +3,16 @@
 #include <excpt.h>
 
 #include <algorithm>
-
+#include <array>
+#include <deque>
+#include <mutex>
+
+#include "ArmorCatalog.h"
+#include "GlobalOutfitLibrary.h"
+#include "JobService.h"
+#include "OutfitLibrary.h"
 #include "OutfitSystemCacheService.h"
+#include "SettingsTransferService.h"
 #include "Utility.h"
 #include "cobb/strings.h"
 #include "cobb/utf8naturalsort.h"
@@ -344,49 +352,41 @@ namespace OutfitSystem {
     //
     namespace ArmorFormSearchUtils {
         static struct {
-            std::vector<std::string> names;
-            std::vector<RE::TESObjectARMO*> armors;
+            std::shared_ptr<const ArmorCatalog> catalog;
+            std::vector<ArmorCatalog::Index> results;
             //
             void setup(std::string nameFilter, bool mustBePlayable) {
                 LogExit exitPrint("ArmorFormSearchUtils.setup"sv);
-                auto data = RE::TESDataHandler::GetSingleton();
-                auto& list = data->GetFormArray(RE::FormType::Armor);
-                const auto size = list.size();
-                this->names.reserve(size);
-                this->armors.reserve(size);
-                for (std::uint32_t i = 0; i < size; i++) {
-                    const auto form = list[i];
-                    if (form && form->formType == RE::FormType::Armor) {
-                        auto armor = skyrim_cast<RE::TESObjectARMO*>(form);
-                        if (!armor) continue;
-                        if (armor->templateArmor)// filter out predefined enchanted variants, to declutter the list
-                            continue;
-                        if (mustBePlayable && !!(armor->formFlags & RE::TESObjectARMO::RecordFlags::kNonPlayable))
-                            continue;
-                        std::string armorName;
-                        {// get name
-                            auto tfn = skyrim_cast<RE::TESFullName*>(armor);
-                            if (tfn)
-                                armorName = tfn->fullName.data();
-                        }
-                        if (armorName.empty())// skip nameless armor
-                            continue;
-                        if (!nameFilter.empty()) {
-                            auto it = std::search(
-                                armorName.begin(), armorName.end(),
-                                nameFilter.begin(), nameFilter.end(),
-                                [](char a, char b) { return toupper(a) == toupper(b); });
-                            if (it == armorName.end())
-                                continue;
-                        }
-                        this->armors.push_back(armor);
-                        this->names.push_back(armorName.c_str());
-                    }
+                auto latest = ArmorCatalog::Get();
+                if (catalog != latest) {
+                    this->results.clear();
+                    catalog = std::move(latest);
+                }
+                // Only named armors are searchable, so nameless ones are skipped here already.
+                std::vector<ArmorCatalog::Index> matches;
+                catalog->search(ArmorCatalog::MakeSearchKey(nameFilter), matches);
+                this->results.reserve(this->results.size() + matches.size());
+                for (const auto i : matches) {
+                    if (catalog->has(i, ArmorCatalog::kTemplated))// filter out predefined enchanted variants, to declutter the list
+                        continue;
+                    if (mustBePlayable && !catalog->has(i, ArmorCatalog::kPlayable))
+                        continue;
+                    this->results.push_back(i);
                 }
             }
+            // Unlike setup, replaces the previous results: a ranking can't be merged into an earlier search.
+            void setupFuzzy(std::string query, bool mustBePlayable, std::size_t limit) {
+                LogExit exitPrint("ArmorFormSearchUtils.setupFuzzy"sv);
+                catalog = ArmorCatalog::Get();
+                catalog->searchFuzzy(ArmorCatalog::MakeSearchKey(query),
+                                     mustBePlayable ? ArmorCatalog::kPlayable : 0,
+                                     ArmorCatalog::kTemplated,
+                                     limit,
+                                     this->results);
+            }
             void clear() {
-                this->names.clear();
-                this->armors.clear();
+                this->results.clear();
+                this->catalog.reset();
             }
         } data;
         //
@@ -399,29 +399,81 @@ namespace OutfitSystem {
             LogExit exitPrint("ArmorFormSearchUtils.Prep"sv);
             data.setup(filter.data(), mustBePlayable);
         }
+        std::int32_t PrepFuzzy(RE::BSScript::IVirtualMachine* registry,
+                               std::uint32_t stackId,
+                               RE::StaticFunctionTag*,
+                               RE::BSFixedString query,
+                               bool mustBePlayable,
+                               std::int32_t maxResults) {
+            LogExit exitPrint("ArmorFormSearchUtils.PrepFuzzy"sv);
+            ERROR_AND_RETURN_EXPR_IF(maxResults <= 0, "The result limit must be positive.", 0, registry, stackId);
+            data.setupFuzzy(query.data(), mustBePlayable, static_cast<std::size_t>(maxResults));
+            return static_cast<std::int32_t>(data.results.size());
+        }
+        // Replaces the search results with every armor matching all of the given conditions. Masks use the same bit
+        // layout as Armor.GetSlotMask; flags are ArmorCatalog::Flags. An empty plugin or keyword list doesn't filter.
+        std::int32_t PrepQuery(RE::BSScript::IVirtualMachine* registry,
+                               std::uint32_t stackId,
+                               RE::StaticFunctionTag*,
+                               std::int32_t slotsAll,
+                               std::int32_t slotsAny,
+                               std::int32_t slotsNone,
+                               std::vector<RE::BSFixedString> plugins,
+                               std::vector<RE::BGSKeyword*> keywordsAll,
+                               std::vector<RE::BGSKeyword*> keywordsAny,
+                               std::int32_t requiredFlags,
+                               std::int32_t excludedFlags,
+                               RE::BSFixedString nameFilter) {
+            LogExit exitPrint("ArmorFormSearchUtils.PrepQuery"sv);
+            data.catalog = ArmorCatalog::Get();
+            const auto& catalog = *data.catalog;
+
+            ArmorCatalog::Query query;
+            query.slotsAll = static_cast<std::uint32_t>(slotsAll);
+            query.slotsAny = static_cast<std::uint32_t>(slotsAny);
+            query.slotsNone = static_cast<std::uint32_t>(slotsNone);
+            query.requiredFlags = static_cast<std::uint8_t>(requiredFlags);
+            query.excludedFlags = static_cast<std::uint8_t>(excludedFlags);
+            if (!plugins.empty()) {
+                auto& indices = query.plugins.emplace();
+                for (const auto& name : plugins) {
+                    if (const auto* plugin = catalog.findPlugin(std::string_view(name.data())))
+                        indices.push_back(static_cast<ArmorCatalog::PluginIndex>(plugin - catalog.pluginTable.data()));
+                    else
+                        registry->TraceStack("A plugin in the query defines no armors; skipping it.", stackId, RE::BSScript::IVirtualMachine::Severity::kWarning);
+                }
+            }
+            for (const auto* keyword : keywordsAll) {
+                if (keyword)
+                    query.keywordsAll.push_back(keyword->formID);
+            }
+            for (const auto* keyword : keywordsAny) {
+                if (keyword)
+                    query.keywordsAny.push_back(keyword->formID);
+            }
+            query.name = ArmorCatalog::MakeSearchKey(nameFilter.data());
+
+            catalog.query(query, data.results);
+            return static_cast<std::int32_t>(data.results.size());
+        }
         std::vector<RE::TESObjectARMO*> GetForms(RE::BSScript::IVirtualMachine* registry,
                                                  std::uint32_t stackId,
                                                  RE::StaticFunctionTag*) {
             LogExit exitPrint("ArmorFormSearchUtils.GetForms"sv);
             std::vector<RE::TESObjectARMO*> result;
-            auto& list = data.armors;
-            for (auto it = list.begin(); it != list.end(); it++)
-                result.push_back(*it);
-            std::vector<RE::TESObjectARMO*> converted_result;
-            converted_result.reserve(result.size());
-            for (const auto ptr : result) {
-                converted_result.push_back((RE::TESObjectARMO*) ptr);
-            }
-            return converted_result;
+            result.reserve(data.results.size());
+            for (const auto i : data.results)
+                result.push_back(data.catalog->forms[i]);
+            return result;
         }
         std::vector<RE::BSFixedString> GetNames(RE::BSScript::IVirtualMachine* registry,
                                                 std::uint32_t stackId,
                                                 RE::StaticFunctionTag*) {
             LogExit exitPrint("ArmorFormSearchUtils.GetNames"sv);
             std::vector<RE::BSFixedString> result;
-            auto& list = data.names;
-            for (auto it = list.begin(); it != list.end(); it++)
-                result.push_back(it->c_str());
+            result.reserve(data.results.size());
+            for (const auto i : data.results)
+                result.push_back(data.catalog->papyrusNames[i]);
             return result;
         }
         void Clear(RE::BSScript::IVirtualMachine* registry, std::uint32_t stackId, RE::StaticFunctionTag*) {
@@ -434,27 +486,16 @@ namespace OutfitSystem {
             kBodySlotMin = 30,
             kBodySlotMax = 61,
         };
-        static struct {
+        // One row per body slot that an armor of the outfit occupies, in slot order, so an armor covering several
+        // slots gets a row for each. Every native builds its own, which keeps them safe to call from several VM
+        // threads at once.
+        struct Result {
             std::vector<std::int32_t> bodySlots;
-            std::vector<std::string> armorNames;
+            std::vector<RE::BSFixedString> armorNames;
             std::vector<RE::TESObjectARMO*> armors;
-        } data;
-        //
-        void Clear(RE::BSScript::IVirtualMachine* registry, std::uint32_t stackId, RE::StaticFunctionTag*) {
-            LogExit exitPrint("BodySlotListing.Clear"sv);
-            data.bodySlots.clear();
-            data.armorNames.clear();
-            data.armors.clear();
-        }
-        void Prep(RE::BSScript::IVirtualMachine* registry,
-                  std::uint32_t stackId,
-                  RE::StaticFunctionTag*,
-                  RE::BSFixedString name) {
-            LogExit exitPrint("BodySlotListing.Prep"sv);
-            data.bodySlots.clear();
-            data.armorNames.clear();
-            data.armors.clear();
-            //
+        };
+        static Result Build(RE::BSScript::IVirtualMachine* registry, std::uint32_t stackId, const RE::BSFixedString& name) {
+            Result result;
             auto& service = ArmorAddonOverrideService::GetInstance();
             try {
                 auto& outfit = service.getOutfit(name.data());
@@ -464,14 +505,14 @@ namespace OutfitSystem {
                     for (auto it = armors.begin(); it != armors.end(); it++) {
                         RE::TESObjectARMO* armor = *it;
                         if (armor && (static_cast<std::uint32_t>(armor->GetSlotMask()) & mask)) {
-                            data.bodySlots.push_back(i);
-                            data.armors.push_back(armor);
+                            result.bodySlots.push_back(i);
+                            result.armors.push_back(armor);
                             {// name
                                 auto pFullName = skyrim_cast<RE::TESFullName*>(armor);
                                 if (pFullName)
-                                    data.armorNames.emplace_back(pFullName->fullName.data());
+                                    result.armorNames.push_back(pFullName->fullName);
                                 else
-                                    data.armorNames.emplace_back("");
+                                    result.armorNames.emplace_back();
                             }
                         }
                     }
@@ -479,61 +520,123 @@ namespace OutfitSystem {
             } catch (std::out_of_range) {
                 registry->TraceStack("The specified outfit does not exist.", stackId, RE::BSScript::IVirtualMachine::Severity::kWarning);
             }
+            return result;
         }
-        std::vector<RE::TESObjectARMO*> GetArmorForms(RE::BSScript::IVirtualMachine* registry,
-                                                      std::uint32_t stackId,
-                                                      RE::StaticFunctionTag*) {
-            LogExit exitPrint("BodySlotListing.GetArmorForms"sv);
-            std::vector<RE::TESObjectARMO*> result;
-            auto& list = data.armors;
-            for (auto it = list.begin(); it != list.end(); it++)
-                result.push_back(*it);
-            std::vector<RE::TESObjectARMO*> converted_result;
-            converted_result.reserve(result.size());
-            for (const auto ptr : result) {
-                converted_result.push_back((RE::TESObjectARMO*) ptr);
-            }
-            return converted_result;
+        // Translation keys of the body slots, as the MCM's BodySlotName builds them.
+        static const RE::BSFixedString& SlotName(std::int32_t slot) {
+            static const auto names = []() {
+                std::array<RE::BSFixedString, kBodySlotMax - kBodySlotMin + 1> names;
+                for (std::int32_t i = kBodySlotMin; i <= kBodySlotMax; ++i)
+                    names[i - kBodySlotMin] = fmt::format("$SkyOutEquSys_BodySlot{}", i).c_str();
+                return names;
+            }();
+            return names[slot - kBodySlotMin];
         }
-        std::vector<RE::BSFixedString> GetArmorNames(RE::BSScript::IVirtualMachine* registry,
-                                                     std::uint32_t stackId,
-                                                     RE::StaticFunctionTag*) {
-            LogExit exitPrint("BodySlotListing.GetArmorNames"sv);
+        //
+        // The natives below each return one of the listing's parallel arrays, so an outfit page needs one call per
+        // column rather than a prep/get/clear sequence and a Papyrus loop to name the slots. Each call repeats the
+        // outfit lookup and the slot scan (32 slots times the outfit's armors): a hash lookup and a few hundred mask
+        // tests for a typical outfit, cheap next to handing the array back to Papyrus, so the MCM's three columns
+        // don't share a build.
+        //
+        std::vector<RE::BSFixedString> GetSlotNames(RE::BSScript::IVirtualMachine* registry,
+                                                    std::uint32_t stackId,
+                                                    RE::StaticFunctionTag*,
+                                                    RE::BSFixedString name) {
+            LogExit exitPrint("BodySlotListing.GetSlotNames"sv);
+            const auto listing = Build(registry, stackId, name);
             std::vector<RE::BSFixedString> result;
-            auto& list = data.armorNames;
-            for (auto it = list.begin(); it != list.end(); it++)
-                result.push_back(it->c_str());
+            result.reserve(listing.bodySlots.size());
+            for (const auto slot : listing.bodySlots)
+                result.push_back(SlotName(slot));
             return result;
         }
         std::vector<std::int32_t> GetSlotIndices(RE::BSScript::IVirtualMachine* registry,
                                                  std::uint32_t stackId,
-                                                 RE::StaticFunctionTag*) {
+                                                 RE::StaticFunctionTag*,
+                                                 RE::BSFixedString name) {
             LogExit exitPrint("BodySlotListing.GetSlotIndices"sv);
-            std::vector<std::int32_t> result;
-            auto& list = data.bodySlots;
-            for (auto it = list.begin(); it != list.end(); it++)
-                result.push_back(*it);
-            return result;
+            return Build(registry, stackId, name).bodySlots;
+        }
+        std::vector<RE::BSFixedString> GetArmorNames(RE::BSScript::IVirtualMachine* registry,
+                                                     std::uint32_t stackId,
+                                                     RE::StaticFunctionTag*,
+                                                     RE::BSFixedString name) {
+            LogExit exitPrint("BodySlotListing.GetArmorNames"sv);
+            return Build(registry, stackId, name).armorNames;
+        }
+        std::vector<RE::TESObjectARMO*> GetArmorForms(RE::BSScript::IVirtualMachine* registry,
+                                                      std::uint32_t stackId,
+                                                      RE::StaticFunctionTag*,
+                                                      RE::BSFixedString name) {
+            LogExit exitPrint("BodySlotListing.GetArmorForms"sv);
+            return Build(registry, stackId, name).armors;
+        }
+        //
+        // Deprecated: the prep/get/clear sequence from before the per-column natives, kept for other scripts that
+        // still call it. The prepared listing is shared by every caller, as it always was; only its access is guarded.
+        //
+        static struct {
+            std::mutex lock;
+            Result listing;
+        } prepared;
+        void Prep(RE::BSScript::IVirtualMachine* registry,
+                  std::uint32_t stackId,
+                  RE::StaticFunctionTag*,
+                  RE::BSFixedString name) {
+            LogExit exitPrint("BodySlotListing.Prep"sv);
+            auto listing = Build(registry, stackId, name);
+            std::lock_guard guard(prepared.lock);
+            prepared.listing = std::move(listing);
+        }
+        void Clear(RE::BSScript::IVirtualMachine* registry, std::uint32_t stackId, RE::StaticFunctionTag*) {
+            LogExit exitPrint("BodySlotListing.Clear"sv);
+            Result empty;
+            std::lock_guard guard(prepared.lock);
+            std::swap(prepared.listing, empty);
+        }
+        std::vector<RE::TESObjectARMO*> GetPreparedArmorForms(RE::BSScript::IVirtualMachine* registry,
+                                                              std::uint32_t stackId,
+                                                              RE::StaticFunctionTag*) {
+            LogExit exitPrint("BodySlotListing.GetPreparedArmorForms"sv);
+            std::lock_guard guard(prepared.lock);
+            return prepared.listing.armors;
+        }
+        std::vector<RE::BSFixedString> GetPreparedArmorNames(RE::BSScript::IVirtualMachine* registry,
+                                                             std::uint32_t stackId,
+                                                             RE::StaticFunctionTag*) {
+            LogExit exitPrint("BodySlotListing.GetPreparedArmorNames"sv);
+            std::lock_guard guard(prepared.lock);
+            return prepared.listing.armorNames;
+        }
+        std::vector<std::int32_t> GetPreparedSlotIndices(RE::BSScript::IVirtualMachine* registry,
+                                                         std::uint32_t stackId,
+                                                         RE::StaticFunctionTag*) {
+            LogExit exitPrint("BodySlotListing.GetPreparedSlotIndices"sv);
+            std::lock_guard guard(prepared.lock);
+            return prepared.listing.bodySlots;
         }
     }// namespace BodySlotListing
     namespace StringSorts {
+        static std::vector<std::string_view> AsViews(const std::vector<RE::BSFixedString>& arr) {
+            std::vector<std::string_view> views;
+            views.reserve(arr.size());
+            for (const auto& entry : arr)
+                views.emplace_back(entry.data());
+            return views;
+        }
+
         std::vector<RE::BSFixedString> NaturalSort_ASCII(RE::BSScript::IVirtualMachine* registry,
                                                          std::uint32_t stackId,
                                                          RE::StaticFunctionTag*,
                                                          std::vector<RE::BSFixedString> arr,
                                                          bool descending) {
             LogExit exitPrint("StringSorts.NaturalSort_ASCII"sv);
-            std::vector<RE::BSFixedString> result = arr;
-            std::sort(
-                result.begin(),
-                result.end(),
-                [descending](const RE::BSFixedString& x, const RE::BSFixedString& y) {
-                    std::string a(x.data());
-                    std::string b(y.data());
-                    if (descending)
-                        std::swap(a, b);
-                    return cobb::utf8::naturalcompare(a, b) > 0;
-                });
+            const auto order = cobb::utf8::naturalorder(AsViews(arr), descending);
+            std::vector<RE::BSFixedString> result;
+            result.reserve(arr.size());
+            for (const auto i : order)
+                result.push_back(arr[i]);
             return result;
         }
 
@@ -546,37 +649,16 @@ namespace OutfitSystem {
             std::vector<T*> second,            // Array of forms (T)
             bool descending) {
             LogExit exitPrint("StringSorts.NaturalSortPair_ASCII"sv);
-            std::size_t size = arr.size();
-            if (size != second.size()) {
+            if (arr.size() != second.size()) {
                 registry->TraceStack("The two arrays must be the same length.", stackId, RE::BSScript::IVirtualMachine::Severity::kError);
                 return second;
             }
-            //
-            typedef std::pair<RE::BSFixedString, T*> _pair;
-            std::vector<_pair> pairs;
-            //
-            std::vector<RE::BSFixedString> result;
-            {// Copy input array into output array
-                result.reserve(size);
-                for (std::uint32_t i = 0; i < size; i++) {
-                    pairs.emplace_back(arr[i], second[i]);
-                }
-            }
-            std::sort(
-                pairs.begin(),
-                pairs.end(),
-                [descending](const _pair& x, const _pair& y) {
-                    std::string a(x.first.data());
-                    std::string b(y.first.data());
-                    if (descending)
-                        std::swap(a, b);
-                    return cobb::utf8::naturalcompare(a, b) > 0;
-                });
-            for (std::uint32_t i = 0; i < size; i++) {
-                result.push_back(pairs[i].first);
-                second[i] = pairs[i].second;
-            }
-            return second;
+            const auto order = cobb::utf8::naturalorder(AsViews(arr), descending);
+            std::vector<T*> result;
+            result.reserve(second.size());
+            for (const auto i : order)
+                result.push_back(second[i]);
+            return result;
         }
     }// namespace StringSorts
     namespace Utility {
@@ -630,6 +712,7 @@ namespace OutfitSystem {
         try {
             auto& outfit = service.getOutfit(name.data());
             outfit.m_armors.insert(armor);
+            outfit.markChanged();
         } catch (std::out_of_range) {
             registry->TraceStack("The specified outfit does not exist.", stackId, RE::BSScript::IVirtualMachine::Severity::kWarning);
         }
@@ -724,7 +807,7 @@ namespace OutfitSystem {
         if (!actor)
             return RE::BSFixedString("");
         auto& service = ArmorAddonOverrideService::GetInstance();
-        return service.currentOutfit(actor).m_name.c_str();
+        return service.currentOutfit(actor).papyrusName();
     }
 
     bool IsEnabled(RE::BSScript::IVirtualMachine* registry, std::uint32_t stackId, RE::StaticFunctionTag*) {
@@ -733,187 +816,6 @@ namespace OutfitSystem {
         return service.enabled;
     }
 
-    bool IsExcludedPlugin(const std::string_view& filename) {
-        // List of default Bethesda plugins
-        static const std::vector<std::string_view> excludedPlugins = {
-            "Skyrim.esm",
-            "Update.esm",
-            "Dawnguard.esm",
-            "HearthFires.esm",
-            "Dragonborn.esm",
-            "Skyrim_VR.esm"
-        };
-
-        // Check if the filename is in the list
-        for (const auto& plugin : excludedPlugins) {
-            if (_stricmp(filename.data(), plugin.data()) == 0) {
-                return true;
-            }
-        }
-
-        return false;
-    }
-
-    namespace ArmorMods {
-        struct ModEntryInfo {
-            std::string filename;
-            uint32_t loadOrderIndex;
-            const RE::TESFile* filePtr; // Add file pointer
-            std::unordered_map<std::string, RE::TESObjectARMO*> armorsMap;
-        };
-
-        std::unordered_map<std::string, ModEntryInfo> g_cachedModMap;
-        std::vector<std::string> g_cachedModList;
-        bool g_isModListCached = false;
-
-        void CacheAllLoadedMods() {
-            g_cachedModList.clear();
-            g_cachedModMap.clear();
-
-            auto dataHandler = RE::TESDataHandler::GetSingleton();
-            if (!dataHandler) {
-                LOG(warn, "DataHandler is null");
-                g_isModListCached = true;
-                return;
-            }
-
-            std::unordered_set<std::string> uniqueMods;
-            std::unordered_map<std::string, ModEntryInfo> userMods;
-
-            auto armorForms = dataHandler->GetFormArray<RE::TESObjectARMO>();
-
-            for (auto armorForm : armorForms) {
-                const RE::TESFile* mod = armorForm->GetFile(0);
-
-                if (!mod)
-                    continue;
-
-                std::string filename = std::string(mod->GetFilename());
-
-                // Skip excluded and duplicate plugins
-                if (!IsExcludedPlugin(filename)) {
-                    std::string armorName = armorForm->GetFullName();
-                    if (armorName.empty()) {
-                        // Use form id
-                        armorName = REUtilities::get_editorID(armorForm);
-                        if (armorName.empty()) {
-                            // Generate default name using form ID
-                            armorName = fmt::format("Outfit_{:X}", armorForm->formID & 0xFFF);
-                        }
-                    }
-
-                    if (uniqueMods.insert(filename).second) {
-                        ModEntryInfo entry;
-                        entry.filename = filename;
-                        entry.loadOrderIndex = mod->GetCompileIndex();
-                        entry.filePtr = mod;
-                        userMods[filename] = entry;
-                    }
-
-                    userMods[filename].armorsMap[armorName] = armorForm;
-
-                    EXTRALOG(info, "Added outfit mod {} for {}", armorName, filename);
-                }
-            }
-
-            g_cachedModList.reserve(userMods.size());
-            for (const auto& mod : userMods) {
-                g_cachedModList.push_back(mod.second.filename);
-                g_cachedModMap[mod.second.filename] = mod.second;
-                EXTRALOG(info, "Done processing: {}, Load order {}, Total Armors {}", mod.second.filename, mod.second.filePtr->GetCompileIndex(), mod.second.armorsMap.size());
-            }
-
-            std::sort(g_cachedModList.begin(), g_cachedModList.end(),
-            [&userMods](const std::string& a, const std::string& b) {
-                const auto aModInfo = userMods[a];
-                const auto bModInfo = userMods[b];
-                return aModInfo.loadOrderIndex < bModInfo.loadOrderIndex;
-            });
-
-            g_isModListCached = true;
-
-            LOG(info, "Total mod count with armors: {}", g_cachedModList.size());
-        }
-    }
-
-    namespace OutfitMods {
-        struct ModEntryInfo {
-            std::string filename;
-            uint32_t loadOrderIndex;
-            const RE::TESFile* filePtr; // Add file pointer
-            std::unordered_map<std::string, RE::BGSOutfit*> outfitsMap;
-        };
-
-        std::unordered_map<std::string, ModEntryInfo> g_cachedModMap;
-        std::vector<std::string> g_cachedModList;
-        bool g_isModListCached = false;
-
-        void CacheAllLoadedMods() {
-            g_cachedModList.clear();
-            g_cachedModMap.clear();
-
-            auto dataHandler = RE::TESDataHandler::GetSingleton();
-            if (!dataHandler) {
-                LOG(warn, "DataHandler is null");
-                g_isModListCached = true;
-                return;
-            }
-
-            std::unordered_set<std::string> uniqueMods;
-            std::unordered_map<std::string, ModEntryInfo> userMods;
-
-            auto outfitForms = dataHandler->GetFormArray<RE::BGSOutfit>();
-
-            for (auto outfitForm : outfitForms) {
-                const RE::TESFile* mod = outfitForm->GetFile(0);
-
-                if (!mod)
-                    continue;
-
-                std::string filename = std::string(mod->GetFilename());
-
-                // Skip excluded and duplicate plugins
-                if (!IsExcludedPlugin(filename)) {
-                    std::string outfitName = REUtilities::get_editorID(outfitForm);
-                    if (outfitName.empty()) {
-                        // Generate default name using form ID
-                        outfitName = fmt::format("Outfit_{:X}", outfitForm->formID & 0xFFF);
-                    }
-
-                    if (uniqueMods.insert(filename).second) {
-                        ModEntryInfo entry;
-                        entry.filename = filename;
-                        entry.loadOrderIndex = mod->GetCompileIndex();
-                        entry.filePtr = mod;
-                        userMods[filename] = entry;
-                    }
-
-                    userMods[filename].outfitsMap[outfitName] = outfitForm;
-
-                    EXTRALOG(info, "Added outfit mod {} for {}", outfitName, filename);
-                }
-            }
-
-            g_cachedModList.reserve(userMods.size());
-            for (const auto& mod : userMods) {
-                g_cachedModList.push_back(mod.second.filename);
-                g_cachedModMap[mod.second.filename] = mod.second;
-                EXTRALOG(info, "Done processing: {}, Load order {}, Total Outfits {}", mod.second.filename, mod.second.filePtr->GetCompileIndex(), mod.second.outfitsMap.size());
-            }
-
-            std::sort(g_cachedModList.begin(), g_cachedModList.end(),
-            [&userMods](const std::string& a, const std::string& b) {
-                const auto aModInfo = userMods[a];
-                const auto bModInfo = userMods[b];
-                return aModInfo.loadOrderIndex < bModInfo.loadOrderIndex;
-            });
-
-            g_isModListCached = true;
-
-            LOG(info, "Total mod count with outfits: {}", g_cachedModList.size());
-        }
-    }
-
     std::vector<std::string> GetAllLoadedOutfitModsList(
         RE::BSScript::IVirtualMachine* registry,
         std::uint32_t stackId,
@@ -921,18 +823,12 @@ namespace OutfitSystem {
     ) {
         std::vector<std::string> result;
 
-        // Use cached mod list
-        if (!OutfitMods::g_isModListCached) {
-            OutfitMods::CacheAllLoadedMods();
+        const auto catalog = ArmorCatalog::Get();
+        result.reserve(catalog->outfitMods().size());
+        for (const auto plugin : catalog->outfitMods()) {
+            result.emplace_back(catalog->pluginTable[plugin].name);
         }
 
-        result.reserve(OutfitMods::g_cachedModList.size());
-        for (const auto & modString : OutfitMods::g_cachedModList) {
-            result.push_back(modString);
-        }
-
-        ranges::sort(result);
-
         return result;
     }
 
@@ -946,25 +842,20 @@ namespace OutfitSystem {
         LOG(info, "Grabbing all outfit records for {}", modName);
         std::vector<std::string> result;
 
-        // Ensure mod list is cached
-        if (!OutfitMods::g_isModListCached) {
-            OutfitMods::CacheAllLoadedMods();
-        }
-
-        if (!OutfitMods::g_cachedModMap.contains(modName)) {
+        const auto catalog = ArmorCatalog::Get();
+        const auto* plugin = catalog->findPlugin(modName);
+        if (!plugin || plugin->excluded) {
             return result;
         }
 
-        // Get all outfits for this mod
-        auto& outfits = OutfitMods::g_cachedModMap[modName].outfitsMap;
-
+        // Already sorted by name
+        const auto outfits = catalog->outfitsOf(*plugin);
         result.reserve(outfits.size());
-        for (const auto& outfitName : outfits | views::keys) {
-            result.push_back(outfitName);
+        for (const auto i : outfits) {
+            if (result.empty() || result.back() != catalog->outfitNames[i])
+                result.emplace_back(catalog->outfitNames[i]);
         }
 
-        ranges::sort(result);
-
         LOG(info, "Mapped {} outfits for {}. Returning {} mods.", outfits.size(), modName, result.size());
 
         return result;
@@ -978,37 +869,22 @@ namespace OutfitSystem {
         LogExit exitPrint("GetAllLoadedArmorModsList"sv);
         std::vector<std::string> result;
 
-        // Use cached mod list
-        if (!ArmorMods::g_isModListCached) {
-            ArmorMods::CacheAllLoadedMods();
-        }
-
-        result.reserve(ArmorMods::g_cachedModList.size());
-        for (const auto & modString : ArmorMods::g_cachedModList) {
-            result.push_back(modString);
+        const auto catalog = ArmorCatalog::Get();
+        result.reserve(catalog->armorMods().size());
+        for (const auto plugin : catalog->armorMods()) {
+            result.emplace_back(catalog->pluginTable[plugin].name);
         }
 
-        ranges::sort(result);
-
         return result;
     }
 
-    std::unordered_map<std::string, RE::TESObjectARMO*> GetAllLoadedArmorsForModMap(
-        std::string modName
-    ) {
-        LOG(info, "Grabbing all armor records for {}", modName);
-
-        // Ensure mod list is cached
-        if (!ArmorMods::g_isModListCached) {
-            ArmorMods::CacheAllLoadedMods();
+    // Armors of a mod in listing order, or an empty span for unknown and excluded plugins.
+    static std::span<const ArmorCatalog::Index> ModArmors(const ArmorCatalog& catalog, const std::string& modName) {
+        const auto* plugin = catalog.findPlugin(modName);
+        if (!plugin || plugin->excluded) {
+            return {};
         }
-
-        if (!ArmorMods::g_cachedModMap.contains(modName)) {
-            std::unordered_map<std::string, RE::TESObjectARMO*> result;
-            return result;
-        }
-
-        return ArmorMods::g_cachedModMap[modName].armorsMap;
+        return catalog.armorsOf(*plugin);
     }
 
     // Paginated list of outfits for a specific mod
@@ -1022,16 +898,14 @@ namespace OutfitSystem {
         LOG(info, "Grabbing all armor records for {}", modName);
         std::vector<std::string> result;
 
-        // Get all outfits for this mod
-        auto armorsMap = GetAllLoadedArmorsForModMap(modName);
+        const auto catalog = ArmorCatalog::Get();
+        const auto rows = ModArmors(*catalog, modName);
 
-        result.reserve(armorsMap.size());
-        for (const auto& armorName : armorsMap | views::keys) {
-            result.push_back(armorName);
+        result.reserve(rows.size());
+        for (const auto i : rows) {
+            result.emplace_back(catalog->listNames[i]);
         }
 
-        ranges::sort(result);
-
         LOG(info, "Mapped {} armors for {} as strings. Returning {} mods.", result.size(), modName, result.size());
 
         return result;
@@ -1044,26 +918,23 @@ namespace OutfitSystem {
         RE::StaticFunctionTag*,
         std::string modName
     ) {
-            LogExit exitPrint("GetAllLoadedArmorsForMod"sv);
-            LOG(info, "Grabbing all armor records for {}", modName);
-
-            // Get all outfits for this mod
-            auto armorsMap = GetAllLoadedArmorsForModMap(modName);
+        LogExit exitPrint("GetAllLoadedArmorsForMod"sv);
+        LOG(info, "Grabbing all armor records for {}", modName);
 
-            // Get sorted armor names by calling the string version
-            auto sortedNames = GetAllLoadedArmorsForModAsStrings(registry, stackId, nullptr, modName);
+        const auto catalog = ArmorCatalog::Get();
+        const auto rows = ModArmors(*catalog, modName);
 
-            // Now create the armor vector using the same order as the sorted names
-            std::vector<RE::TESObjectARMO*> result;
-            result.reserve(sortedNames.size());
-            for (const auto& name : sortedNames) {
-                result.push_back(armorsMap[name]);
-            }
+        // Same order as the names returned by GetAllLoadedArmorsForModAsStrings
+        std::vector<RE::TESObjectARMO*> result;
+        result.reserve(rows.size());
+        for (const auto i : rows) {
+            result.push_back(catalog->forms[i]);
+        }
 
-            LOG(info, "Mapped {} armors for {}. Returning {} mods.", result.size(), modName, result.size());
+        LOG(info, "Mapped {} armors for {}. Returning {} mods.", result.size(), modName, result.size());
 
-            return result;
-        }
+        return result;
+    }
 
     // Add a function to refresh the cache if needed (e.g., after mod installation during runtime)
     void RefreshModCache(
@@ -1071,8 +942,16 @@ namespace OutfitSystem {
         std::uint32_t stackId,
         RE::StaticFunctionTag*
     ) {
-        OutfitMods::g_isModListCached = false;
-        OutfitMods::CacheAllLoadedMods();
+        ArmorCatalog::BuildAsync();
+    }
+    // RefreshModCache as a job, which finishes once the new catalog is ready; its result is the number of armors.
+    std::int32_t StartRefreshModCache(RE::BSScript::IVirtualMachine* registry, std::uint32_t stackId, RE::StaticFunctionTag*) {
+        LogExit exitPrint("StartRefreshModCache"sv);
+        // The forms are read here, on the main thread; the job only waits for the indexing.
+        auto pending = ArmorCatalog::BuildAsync();
+        return JobService::GetSingleton().Start("RefreshModCache", [pending = std::move(pending)](const auto& job) {
+            job->finish(true, static_cast<std::int32_t>(pending.get()->size()));
+        })->id();
     }
 
     std::vector<RE::BSFixedString> ListOutfits(RE::BSScript::IVirtualMachine* registry,
@@ -1083,13 +962,162 @@ namespace OutfitSystem {
         LogExit exitPrint("ListOutfits"sv);
         auto& service = ArmorAddonOverrideService::GetInstance();
         std::vector<RE::BSFixedString> result;
-        std::vector<std::string> intermediate;
-        service.getOutfitNames(intermediate, favoritesOnly);
-        result.reserve(intermediate.size());
-        for (auto it = intermediate.begin(); it != intermediate.end(); ++it)
-            result.push_back(it->c_str());
+        service.getOutfitNames(result, favoritesOnly);
         return result;
     }
+    std::vector<RE::BSFixedString> ListOutfitsSorted(RE::BSScript::IVirtualMachine* registry,
+                                                     std::uint32_t stackId,
+                                                     RE::StaticFunctionTag*,
+                                                     bool favoritesOnly,
+                                                     std::int32_t offset,
+                                                     std::int32_t limit) {
+        LogExit exitPrint("ListOutfitsSorted"sv);
+        std::vector<RE::BSFixedString> result;
+        ERROR_AND_RETURN_EXPR_IF(offset < 0 || limit < 0, "The offset and limit can't be negative.", result, registry, stackId);
+        auto& service = ArmorAddonOverrideService::GetInstance();
+        service.getOutfitNames(result, favoritesOnly, static_cast<std::size_t>(offset), static_cast<std::size_t>(limit));
+        return result;
+    }
+    std::int32_t CountOutfits(RE::BSScript::IVirtualMachine* registry,
+                              std::uint32_t stackId,
+                              RE::StaticFunctionTag*,
+                              bool favoritesOnly) {
+        LogExit exitPrint("CountOutfits"sv);
+        auto& service = ArmorAddonOverrideService::GetInstance();
+        return static_cast<std::int32_t>(service.countOutfits(favoritesOnly));
+    }
+    namespace PagedListing {
+        // A listing is snapshotted when it is opened, so paging through it stays consistent even if the catalog is
+        // rebuilt or outfits change in between. Only the most recently opened few are kept; a closed or evicted
+        // cursor reads as empty.
+        constexpr std::size_t kMaxOpenListings = 8;
+
+        struct Listing {
+            std::int32_t cursor;
+            std::vector<RE::TESObjectARMO*> armors;// empty for outfit listings
+            std::vector<RE::BSFixedString> names;
+        };
+
+        static struct {
+            std::mutex lock;
+            std::deque<Listing> listings;
+            std::int32_t nextCursor = 1;
+        } data;
+
+        std::int32_t Store(Listing listing) {
+            std::lock_guard guard(data.lock);
+            listing.cursor = data.nextCursor++;
+            if (data.nextCursor <= 0)
+                data.nextCursor = 1;
+            if (data.listings.size() >= kMaxOpenListings)
+                data.listings.pop_front();
+            data.listings.push_back(std::move(listing));
+            return data.listings.back().cursor;
+        }
+
+        template <typename T, typename Source, typename Convert>
+        std::vector<T> Page(std::int32_t cursor, std::int32_t offset, std::int32_t limit, Source source, Convert convert) {
+            std::vector<T> result;
+            if (offset < 0 || limit <= 0)
+                return result;
+            std::lock_guard guard(data.lock);
+            for (const auto& listing : data.listings) {
+                if (listing.cursor != cursor)
+                    continue;
+                const auto& items = listing.*source;
+                const auto begin = std::min(items.size(), static_cast<std::size_t>(offset));
+                const auto end = std::min(items.size(), begin + static_cast<std::size_t>(limit));
+                result.reserve(end - begin);
+                for (auto i = begin; i < end; ++i)
+                    result.push_back(convert(items[i]));
+                break;
+            }
+            return result;
+        }
+
+        std::int32_t OpenArmorModListing(RE::BSScript::IVirtualMachine* registry,
+                                         std::uint32_t stackId,
+                                         RE::StaticFunctionTag*,
+                                         std::string modName) {
+            LogExit exitPrint("PagedListing.OpenArmorModListing"sv);
+            Listing listing{};
+            const auto catalog = ArmorCatalog::Get();
+            const auto rows = ModArmors(*catalog, modName);
+            listing.armors.reserve(rows.size());
+            listing.names.reserve(rows.size());
+            for (const auto i : rows) {
+                listing.armors.push_back(catalog->forms[i]);
+                listing.names.push_back(catalog->papyrusListNames[i]);
+            }
+            return Store(std::move(listing));
+        }
+
+        std::int32_t OpenArmorSearchListing(RE::BSScript::IVirtualMachine* registry,
+                                            std::uint32_t stackId,
+                                            RE::StaticFunctionTag*) {
+            LogExit exitPrint("PagedListing.OpenArmorSearchListing"sv);
+            Listing listing{};
+            if (const auto& catalog = ArmorFormSearchUtils::data.catalog) {
+                const auto& rows = ArmorFormSearchUtils::data.results;
+                listing.armors.reserve(rows.size());
+                listing.names.reserve(rows.size());
+                for (const auto i : rows) {
+                    listing.armors.push_back(catalog->forms[i]);
+                    listing.names.push_back(catalog->papyrusNames[i]);
+                }
+            }
+            return Store(std::move(listing));
+        }
+
+        std::int32_t OpenOutfitListing(RE::BSScript::IVirtualMachine* registry,
+                                       std::uint32_t stackId,
+                                       RE::StaticFunctionTag*,
+                                       bool favoritesOnly) {
+            LogExit exitPrint("PagedListing.OpenOutfitListing"sv);
+            Listing listing{};
+            ArmorAddonOverrideService::GetInstance().getOutfitNames(listing.names, favoritesOnly);
+            return Store(std::move(listing));
+        }
+
+        std::int32_t GetSize(RE::BSScript::IVirtualMachine* registry,
+                             std::uint32_t stackId,
+                             RE::StaticFunctionTag*,
+                             std::int32_t cursor) {
+            LogExit exitPrint("PagedListing.GetSize"sv);
+            std::lock_guard guard(data.lock);
+            for (const auto& listing : data.listings) {
+                if (listing.cursor == cursor)
+                    return static_cast<std::int32_t>(listing.names.size());
+            }
+            return -1;
+        }
+
+        std::vector<RE::TESObjectARMO*> GetArmors(RE::BSScript::IVirtualMachine* registry,
+                                                  std::uint32_t stackId,
+                                                  RE::StaticFunctionTag*,
+                                                  std::int32_t cursor,
+                                                  std::int32_t offset,
+                                                  std::int32_t limit) {
+            LogExit exitPrint("PagedListing.GetArmors"sv);
+            return Page<RE::TESObjectARMO*>(cursor, offset, limit, &Listing::armors, [](RE::TESObjectARMO* armor) { return armor; });
+        }
+
+        std::vector<RE::BSFixedString> GetNames(RE::BSScript::IVirtualMachine* registry,
+                                                std::uint32_t stackId,
+                                                RE::StaticFunctionTag*,
+                                                std::int32_t cursor,
+                                                std::int32_t offset,
+                                                std::int32_t limit) {
+            LogExit exitPrint("PagedListing.GetNames"sv);
+            return Page<RE::BSFixedString>(cursor, offset, limit, &Listing::names, [](const RE::BSFixedString& name) { return name; });
+        }
+
+        void Close(RE::BSScript::IVirtualMachine* registry, std::uint32_t stackId, RE::StaticFunctionTag*, std::int32_t cursor) {
+            LogExit exitPrint("PagedListing.Close"sv);
+            std::lock_guard guard(data.lock);
+            std::erase_if(data.listings, [cursor](const Listing& listing) { return listing.cursor == cursor; });
+        }
+    }// namespace PagedListing
     void RemoveArmorFromOutfit(RE::BSScript::IVirtualMachine* registry, std::uint32_t stackId, RE::StaticFunctionTag*,
 
                                RE::BSFixedString name,
@@ -1101,6 +1129,7 @@ namespace OutfitSystem {
         try {
             auto& outfit = service.getOutfit(name.data());
             outfit.m_armors.erase(armor);
+            outfit.markChanged();
         } catch (std::out_of_range) {
             registry->TraceStack("The specified outfit does not exist.", stackId, RE::BSScript::IVirtualMachine::Severity::kWarning);
         }
@@ -1134,6 +1163,8 @@ namespace OutfitSystem {
             }
             for (auto it = conflicts.begin(); it != conflicts.end(); ++it)
                 armors.erase(*it);
+            if (!conflicts.empty())
+                outfit.markChanged();
         } catch (std::out_of_range) {
             registry->TraceStack("The specified outfit does not exist.", stackId, RE::BSScript::IVirtualMachine::Severity::kError);
             return;
@@ -1184,21 +1215,31 @@ namespace OutfitSystem {
         LogExit exitPrint("OverwriteOutfit"sv);
         auto& service = ArmorAddonOverrideService::GetInstance();
         try {
-            auto& outfit = service.getOrCreateOutfit(name.data());
-            outfit.m_armors.clear();
-            auto count = armors.size();
-            for (std::uint32_t i = 0; i < count; i++) {
-                RE::TESObjectARMO* ptr = nullptr;
-                ptr = armors.at(i);
-                if (ptr)
-                    outfit.m_armors.insert(ptr);
-            }
+            service.overwriteOutfit(name.data(), armors);
         } catch (ArmorAddonOverrideService::bad_name) {
             registry->TraceStack("Invalid outfit name specified.", stackId, RE::BSScript::IVirtualMachine::Severity::kError);
             return;
         }
     }
 
+    // returns the status, 1 for success, 0 for failure.
+    static uint32_t AddOutfitFormToOutfitList(RE::BSScript::IVirtualMachine* registry,
+                      std::uint32_t stackId,
+                      const std::string& outfitName,
+                      RE::BGSOutfit* outfitForm
+    ) {
+        std::vector<RE::TESObjectARMO*> outfitArmors = REUtilities::OutfitToArmorList(outfitForm);
+
+        try {
+            OverwriteOutfit(registry, stackId, nullptr, outfitName, outfitArmors);
+            return 1;
+        }
+        catch (const std::exception& e) {
+            LOG(critical, "Failed to add outfit {}", outfitName);
+            return 0;
+        }
+    }
+
     // returns the status, 1 for success, 0 for failure.
     uint32_t AddOutfitFromModToOutfitList(RE::BSScript::IVirtualMachine* registry,
                       std::uint32_t stackId,
@@ -1206,45 +1247,25 @@ namespace OutfitSystem {
                       std::string modName,
                       std::string formEditorID
     ) {
-        // Ensure mod list is cached
-        if (!OutfitMods::g_isModListCached) {
-            OutfitMods::CacheAllLoadedMods();
-        }
-
-        auto modIt = OutfitMods::g_cachedModMap.find(modName);
+        const auto catalog = ArmorCatalog::Get();
+        const auto* plugin = catalog->findPlugin(modName);
 
-        if (modIt == OutfitMods::g_cachedModMap.end()) {
+        if (!plugin || plugin->excluded || plugin->outfitCount == 0) {
             return 0;
         }
 
-        if (modIt->second.outfitsMap.empty()) {
-            // attempt to load up outfits
-            auto outfits = GetAllLoadedOutfitsForMod(registry, stackId, nullptr, modName);
-            auto modItRetry = OutfitMods::g_cachedModMap.find(modName);
-
-            if (outfits.empty() || modItRetry->second.outfitsMap.empty()) {
-                LOG(critical, "Failed to load any outfits for {}", modName);
-                return 0;
-            }
+        // Like the listing, the last record with a given editor ID wins.
+        RE::BGSOutfit* outfitForm = nullptr;
+        for (const auto i : catalog->outfitsOf(*plugin)) {
+            if (catalog->outfitNames[i] == formEditorID)
+                outfitForm = catalog->outfitForms[i];
         }
 
-        // Get outfits for this mod
-        auto outfit = modIt->second.outfitsMap.find(formEditorID);
-
-        if (outfit == modIt->second.outfitsMap.end()) {
+        if (!outfitForm) {
             return 0;
         }
 
-        std::vector<RE::TESObjectARMO*> outfitArmors = REUtilities::OutfitToArmorList(outfit->second);
-
-        try {
-            OverwriteOutfit(registry, stackId, nullptr, outfit->first, outfitArmors);
-            return 1;
-        }
-        catch (const std::exception& e) {
-            LOG(critical, "Failed to add outfit {} from mod {}", formEditorID, modName);
-            return 0;
-        }
+        return AddOutfitFormToOutfitList(registry, stackId, formEditorID, outfitForm);
     }
 
     // Function to add all outfits from a mod to the outfit list
@@ -1254,30 +1275,24 @@ namespace OutfitSystem {
                           RE::StaticFunctionTag*,
                           std::string modName)
     {
-        // Ensure mod list is cached
-        if (!OutfitMods::g_isModListCached) {
-            OutfitMods::CacheAllLoadedMods();
-        }
+        const auto catalog = ArmorCatalog::Get();
+        const auto* plugin = catalog->findPlugin(modName);
 
-        auto modIt = OutfitMods::g_cachedModMap.find(modName);
-
-        if (modIt == OutfitMods::g_cachedModMap.end()) {
-            LOG(critical, "Could not find mod {} in cached mod map", modName);
+        if (!plugin || plugin->excluded) {
+            LOG(critical, "Could not find mod {} in the armor catalog", modName);
             return 0;
         }
 
-        if (modIt->second.outfitsMap.empty()) {
-            // attempt to load up outfits
-            auto outfits = GetAllLoadedOutfitsForMod(registry, stackId, nullptr, modName);
-            auto modItRetry = OutfitMods::g_cachedModMap.find(modName);
-
-            if (outfits.empty() || modItRetry->second.outfitsMap.empty()) {
-                LOG(critical, "Failed to load any outfits for {}", modName);
-                return 0;
-            }
+        if (plugin->outfitCount == 0) {
+            LOG(critical, "Failed to load any outfits for {}", modName);
+            return 0;
         }
 
-        unordered_map<string, RE::BGSOutfit*> outfitMap = modIt->second.outfitsMap;
+        unordered_map<string, RE::BGSOutfit*> outfitMap;
+        outfitMap.reserve(plugin->outfitCount);
+        for (const auto i : catalog->outfitsOf(*plugin)) {
+            outfitMap.insert_or_assign(std::string(catalog->outfitNames[i]), catalog->outfitForms[i]);
+        }
         uint32_t addedCount = 0;
 
         // Iterate through all outfits in the mod
@@ -1288,8 +1303,7 @@ namespace OutfitSystem {
                 continue;
             }
 
-            // Call the existing function to add each outfit
-            uint32_t result = AddOutfitFromModToOutfitList(registry, stackId, nullptr, modName, formEditorID);
+            uint32_t result = AddOutfitFormToOutfitList(registry, stackId, formEditorID, outfitPtr);
 
             // If result equal to or above 1, the outfit was successfully added
             if (result >= 1) {
@@ -1307,6 +1321,74 @@ namespace OutfitSystem {
         return addedCount;
     }
 
+    // AddAllOutfitsFromModToOutfitList as a job. The outfits' leveled lists are resolved on the worker thread and
+    // only the resulting armor lists are written to the service, in one main thread task. The job's result is the
+    // number of outfits added.
+    std::int32_t StartAddAllOutfitsFromModToOutfitList(RE::BSScript::IVirtualMachine* registry,
+                                                       std::uint32_t stackId,
+                                                       RE::StaticFunctionTag*,
+                                                       std::string modName) {
+        LogExit exitPrint("StartAddAllOutfitsFromModToOutfitList"sv);
+        return JobService::GetSingleton().Start("AddAllOutfitsFromMod", [modName](const auto& job) {
+            const auto catalog = ArmorCatalog::Get();
+            const auto* plugin = catalog->findPlugin(modName);
+            if (!plugin || plugin->excluded || plugin->outfitCount == 0) {
+                LOG(critical, "Could not find any outfits of mod {} in the armor catalog", modName);
+                job->finish(false);
+                return;
+            }
+
+            struct Resolved {
+                std::string name;
+                std::vector<RE::TESObjectARMO*> armors;
+            };
+            auto resolved = std::make_shared<std::vector<Resolved>>();
+            const auto rows = catalog->outfitsOf(*plugin);
+            resolved->reserve(rows.size());
+            job->setTotal(static_cast<std::uint32_t>(rows.size()));
+            for (const auto i : rows) {
+                job->advance();
+                const auto* outfitForm = catalog->outfitForms[i];
+                if (!outfitForm) {
+                    LOG(critical, "Skipping null outfit with formEditorID: {}", catalog->outfitNames[i]);
+                    continue;
+                }
+                // Rows are sorted by editor ID; like the listing, the last record with a given editor ID wins.
+                if (resolved->empty() || resolved->back().name != catalog->outfitNames[i])
+                    resolved->push_back({std::string(catalog->outfitNames[i]), {}});
+                resolved->back().armors = REUtilities::OutfitToArmorList(catalog->outfitForms[i]);
+            }
+
+            SKSE::GetTaskInterface()->AddTask([job, resolved, modName]() {
+                auto& service = ArmorAddonOverrideService::GetInstance();
+                std::int32_t addedCount = 0;
+                for (const auto& [name, armors] : *resolved) {
+                    try {
+                        service.overwriteOutfit(name.c_str(), armors);
+                        addedCount++;
+                        EXTRALOG(info, "Successfully added outfit {} from mod {}", name, modName);
+                    } catch (ArmorAddonOverrideService::bad_name) {
+                        LOG(critical, "Failed to add outfit {} from mod {}", name, modName);
+                    }
+                }
+                LOG(info, "Added {} outfits to {}.", addedCount, modName);
+                job->finish(addedCount > 0, addedCount);
+            });
+        })->id();
+    }
+    std::int32_t GetJobStatus(RE::BSScript::IVirtualMachine* registry, std::uint32_t stackId, RE::StaticFunctionTag*, std::int32_t job) {
+        LogExit exitPrint("GetJobStatus"sv);
+        return static_cast<std::int32_t>(JobService::GetSingleton().GetStatus(job));
+    }
+    float GetJobProgress(RE::BSScript::IVirtualMachine* registry, std::uint32_t stackId, RE::StaticFunctionTag*, std::int32_t job) {
+        LogExit exitPrint("GetJobProgress"sv);
+        return JobService::GetSingleton().GetProgress(job);
+    }
+    std::int32_t GetJobResult(RE::BSScript::IVirtualMachine* registry, std::uint32_t stackId, RE::StaticFunctionTag*, std::int32_t job) {
+        LogExit exitPrint("GetJobResult"sv);
+        return JobService::GetSingleton().GetResult(job);
+    }
+
     void SetEnabled(RE::BSScript::IVirtualMachine* registry,
                     std::uint32_t stackId,
                     RE::StaticFunctionTag*,
@@ -1495,38 +1577,35 @@ namespace OutfitSystem {
         return result;
     }
 
-    std::optional<LocationType> identifyLocation(RE::BGSLocation* location, RE::TESWeather* weather, RE::Actor* target) {
-        LogExit exitPrint("identifyLocation"sv);
-        // Just a helper function to classify a location.
-        // TODO: Think of a better place than this since we're not exposing it to Papyrus.
-        auto& service = ArmorAddonOverrideService::GetInstance();
-
-        // Collect weather information.
+    WeatherFlags collectWeatherFlags(RE::TESWeather* weather) {
         WeatherFlags weather_flags;
         if (weather) {
             weather_flags.snowy = weather->data.flags.any(RE::TESWeather::WeatherDataFlag::kSnow);
             weather_flags.rainy = weather->data.flags.any(RE::TESWeather::WeatherDataFlag::kRainy);
         }
+        return weather_flags;
+    }
 
-        // Collect location keywords
+    std::unordered_set<std::string> collectLocationKeywords(RE::BGSLocation* location) {
         std::unordered_set<std::string> keywords;
         keywords.reserve(20);
         while (location) {
             std::uint32_t max = location->GetNumKeywords();
             for (std::uint32_t i = 0; i < max; i++) {
                 RE::BGSKeyword* keyword = location->GetKeywordAt(i).value();
-                /*
-                char message[100];
-                LOG(info, "SOS: Location has Keyword %s", keyword->GetFormEditorID());
-                sprintf(message, "SOS: Location has keyword %s", keyword->GetFormEditorID());
-                REUtilities::DebugNotification(message);
-                */
                 keywords.emplace(keyword->GetFormEditorID());
             }
             location = location->parentLoc;
         }
+        return keywords;
+    }
 
-        return service.checkLocationType(keywords, weather_flags, REUtilities::CurrentGameDayPart(), target);
+    std::optional<LocationType> identifyLocation(RE::BGSLocation* location, RE::TESWeather* weather, RE::Actor* target) {
+        LogExit exitPrint("identifyLocation"sv);
+        // Just a helper function to classify a location.
+        // TODO: Think of a better place than this since we're not exposing it to Papyrus.
+        auto& service = ArmorAddonOverrideService::GetInstance();
+        return service.checkLocationType(collectLocationKeywords(location), collectWeatherFlags(weather), REUtilities::CurrentGameDayPart(), target);
     }
 
     std::uint32_t IdentifyLocationType(RE::BSScript::IVirtualMachine* registry,
@@ -1548,20 +1627,23 @@ namespace OutfitSystem {
         auto& service = ArmorAddonOverrideService::GetInstance();
         auto actors = service.listActors();
 
+        // Location and weather are the same for everyone, so only the actor's own state differs per entry.
+        const std::uint32_t sharedContext =
+            ArmorAddonOverrideService::locationContextFromKeywords(collectLocationKeywords(location_skse)) |
+            ArmorAddonOverrideService::locationContextFromWorld(collectWeatherFlags(weather_skse), REUtilities::CurrentGameDayPart());
+
+        ActorContextBatch batch;
+        batch.reserve(actors.size());
         for (auto& actor : actors) {
             if (!actor || !actor->Is3DLoaded()) continue;
+            batch.push(actor,
+                       sharedContext | ArmorAddonOverrideService::locationContextForActor(actor),
+                       service.assignmentMaskForActor(actor));
+        }
 
-            auto location = identifyLocation(location_skse, weather_skse, actor);
-            // Debug notifications for location classification.
-            /*
-            const char* locationName = locationTypeStrings[static_cast<std::uint32_t>(location)];
-            char message[100];
-            sprintf_s(message, "SOS: This location is a %s.", locationName);
-            REUtilities::DebugNotification(message);
-            */
-            if (location.has_value()) {
-                service.setOutfitUsingLocation(location.value(), actor);
-            }
+        auto locations = service.classifyActors(batch);
+        for (std::size_t i = 0; i < locations.size(); i++) {
+            service.setOutfitUsingLocation(locations[i], batch.actors[i]);
         }
     }
 
@@ -1602,14 +1684,25 @@ namespace OutfitSystem {
         LogExit exitPrint("GetLocationOutfit"sv);
         if (!actor)
             return RE::BSFixedString("");
-        auto outfit = ArmorAddonOverrideService::GetInstance()
-                          .getLocationOutfit(LocationType(location), actor);
-        if (outfit.has_value()) {
-            return RE::BSFixedString(outfit.value().c_str());
-        } else {
-            // Empty string means "no outfit assigned" for this location type.
-            return RE::BSFixedString("");
-        }
+        // Empty string means "no outfit assigned" for this location type.
+        return ArmorAddonOverrideService::GetInstance()
+            .getLocationOutfitName(LocationType(location), actor);
+    }
+    // GetLocationOutfit for several location types in one call; the names are parallel to the given types.
+    std::vector<RE::BSFixedString> GetLocationOutfits(RE::BSScript::IVirtualMachine* registry,
+                                                      std::uint32_t stackId,
+                                                      RE::StaticFunctionTag*,
+                                                      RE::Actor* actor,
+                                                      std::vector<std::int32_t> locations) {
+        LogExit exitPrint("GetLocationOutfits"sv);
+        std::vector<RE::BSFixedString> result;
+        if (!actor)
+            return result;
+        auto& service = ArmorAddonOverrideService::GetInstance();
+        result.reserve(locations.size());
+        for (const auto location : locations)
+            result.push_back(service.getLocationOutfitName(LocationType(location), actor));
+        return result;
     }
 
     void SetLoveSceneForActors(
@@ -1647,57 +1740,90 @@ namespace OutfitSystem {
 
     bool ExportSettings(RE::BSScript::IVirtualMachine* registry, std::uint32_t stackId, RE::StaticFunctionTag*) {
         LogExit exitPrint("ExportSettings"sv);
-        std::string outputFile = GetRuntimeDirectory() + "Data\\SKSE\\Plugins\\OutfitEquipmentSystemNGData.json";
+        // Snapshot here so the export reflects the state at the time of the call; the JSON conversion and the file
+        // write happen on a worker thread.
         auto& service = ArmorAddonOverrideService::GetInstance();
-        proto::OutfitSystem data = service.save();
-        std::string output;
-        google::protobuf::util::JsonPrintOptions options;
-        options.add_whitespace = true;
-        google::protobuf::util::MessageToJsonString(data, &output, options);
-        std::ofstream file(outputFile);
-        if (file) {
-            file << output;
-        } else {
-            REUtilities::DebugNotification("Failed to open config for writing");
+        auto& transfer = SettingsTransferService::GetSingleton();
+        if (transfer.IsBusy()) {
+            REUtilities::DebugNotification("A config import or export is already running");
             return false;
         }
-        if (file.good()) {
-            std::string message = "Wrote JSON config to " + outputFile;
-            REUtilities::DebugNotification(message);
-            return true;
-        } else {
-            REUtilities::DebugNotification("Failed to write config");
+        // saveForExport() reads any outfits still waiting in the outfit library, so the exported file stands on its own.
+        if (transfer.StartExport(service.saveForExport()) == JobService::kNoJob) {
+            REUtilities::DebugNotification("A config import or export is already running");
             return false;
         }
+        return true;
     }
 
     bool ImportSettings(RE::BSScript::IVirtualMachine* registry, std::uint32_t stackId, RE::StaticFunctionTag*) {
         LogExit exitPrint("ImportSettings"sv);
-        std::string inputFile = GetRuntimeDirectory() + "Data\\SKSE\\Plugins\\OutfitEquipmentSystemNGData.json";
-        std::ifstream file(inputFile);
-        if (!file) {
-            REUtilities::DebugNotification("Failed to open config for reading");
+        if (SettingsTransferService::GetSingleton().StartImport() == JobService::kNoJob) {
+            REUtilities::DebugNotification("A config import or export is already running");
             return false;
         }
-        std::stringstream input;
-        input << file.rdbuf();
-        if (!file.good()) {
-            REUtilities::DebugNotification("Failed to read config data");
+        return true;
+    }
+
+    bool ExportOutfitLibrary(RE::BSScript::IVirtualMachine* registry, std::uint32_t stackId, RE::StaticFunctionTag*) {
+        LogExit exitPrint("ExportOutfitLibrary"sv);
+        auto& transfer = SettingsTransferService::GetSingleton();
+        if (transfer.IsBusy()) {
+            REUtilities::DebugNotification("A config import or export is already running");
             return false;
         }
-        proto::OutfitSystem data;
-        auto status = google::protobuf::util::JsonStringToMessage(input.str(), &data);
-        if (!status.ok()) {
-            REUtilities::DebugNotification("Failed to parse config data. Invalid syntax.");
+        // Forms are resolved here; only the file writes go to the worker thread.
+        auto data = OutfitLibrary::BuildExport(ArmorAddonOverrideService::GetInstance());
+        if (transfer.StartLibraryExport(std::move(data)) == JobService::kNoJob) {
+            REUtilities::DebugNotification("A config import or export is already running");
+            return false;
+        }
+        return true;
+    }
+
+    bool ExportGlobalOutfitLibrary(RE::BSScript::IVirtualMachine* registry, std::uint32_t stackId, RE::StaticFunctionTag*) {
+        LogExit exitPrint("ExportGlobalOutfitLibrary"sv);
+        auto& transfer = SettingsTransferService::GetSingleton();
+        if (transfer.IsBusy()) {
+            REUtilities::DebugNotification("A config import or export is already running");
+            return false;
+        }
+        auto contents = GlobalOutfitLibrary::Build(ArmorAddonOverrideService::GetInstance());
+        if (transfer.StartGlobalLibraryExport(std::move(contents)) == JobService::kNoJob) {
+            REUtilities::DebugNotification("A config import or export is already running");
+            return false;
+        }
+        return true;
+    }
+
+    bool ImportOutfitLibrary(RE::BSScript::IVirtualMachine* registry, std::uint32_t stackId, RE::StaticFunctionTag*) {
+        LogExit exitPrint("ImportOutfitLibrary"sv);
+        if (SettingsTransferService::GetSingleton().StartLibraryImport() == JobService::kNoJob) {
+            REUtilities::DebugNotification("A config import or export is already running");
             return false;
         }
-        auto& service = ArmorAddonOverrideService::GetInstance();
-        service = ArmorAddonOverrideService(data, SKSE::GetSerializationInterface());
-        std::string message = "Read JSON config from " + inputFile;
-        REUtilities::DebugNotification(message);
         return true;
     }
 
+    std::int32_t GetSettingsTransferStatus(RE::BSScript::IVirtualMachine* registry, std::uint32_t stackId, RE::StaticFunctionTag*) {
+        LogExit exitPrint("GetSettingsTransferStatus"sv);
+        return static_cast<std::int32_t>(SettingsTransferService::GetSingleton().GetStatus());
+    }
+
+    std::int32_t GetSettingsTransferJob(RE::BSScript::IVirtualMachine* registry, std::uint32_t stackId, RE::StaticFunctionTag*) {
+        LogExit exitPrint("GetSettingsTransferJob"sv);
+        return SettingsTransferService::GetSingleton().GetJob();
+    }
+
+    // Also callable from the console: cgf "SkyrimOutfitEquipmentSystemNativeFuncs.DumpNativeProfile" 0
+    std::int32_t DumpNativeProfile(RE::BSScript::IVirtualMachine* registry, std::uint32_t stackId, RE::StaticFunctionTag*, bool reset) {
+        LogExit exitPrint("DumpNativeProfile"sv);
+        const auto count = NativeProfiler::Dump();
+        if (reset)
+            NativeProfiler::Reset();
+        return static_cast<std::int32_t>(count);
+    }
+
     uint32_t GetIniOptionValueFor(RE::BSScript::IVirtualMachine* registry, std::uint32_t stackId, RE::StaticFunctionTag*, std::string option) {
         LogExit exitPrint("GetIniOptionValueFor"sv);
         if (option == "Logging") {
@@ -1860,6 +1986,14 @@ bool OutfitSystem::RegisterPapyrus(RE::BSScript::IVirtualMachine* registry) {
             "PrepArmorSearch",
             "SkyrimOutfitEquipmentSystemNativeFuncs",
             ArmorFormSearchUtils::Prep);
+        registry->RegisterFunction(
+            "PrepArmorSearchFuzzy",
+            "SkyrimOutfitEquipmentSystemNativeFuncs",
+            ArmorFormSearchUtils::PrepFuzzy);
+        registry->RegisterFunction(
+            "PrepArmorQuery",
+            "SkyrimOutfitEquipmentSystemNativeFuncs",
+            ArmorFormSearchUtils::PrepQuery);
         registry->RegisterFunction(
             "GetArmorSearchResultForms",
             "SkyrimOutfitEquipmentSystemNativeFuncs",
@@ -1873,7 +2007,53 @@ bool OutfitSystem::RegisterPapyrus(RE::BSScript::IVirtualMachine* registry) {
             "SkyrimOutfitEquipmentSystemNativeFuncs",
             ArmorFormSearchUtils::Clear);
     }
+    {// paged listings
+        registry->RegisterFunction(
+            "OpenArmorModListing",
+            "SkyrimOutfitEquipmentSystemNativeFuncs",
+            PagedListing::OpenArmorModListing);
+        registry->RegisterFunction(
+            "OpenArmorSearchListing",
+            "SkyrimOutfitEquipmentSystemNativeFuncs",
+            PagedListing::OpenArmorSearchListing);
+        registry->RegisterFunction(
+            "OpenOutfitListing",
+            "SkyrimOutfitEquipmentSystemNativeFuncs",
+            PagedListing::OpenOutfitListing);
+        registry->RegisterFunction(
+            "GetListingSize",
+            "SkyrimOutfitEquipmentSystemNativeFuncs",
+            PagedListing::GetSize);
+        registry->RegisterFunction(
+            "GetListingArmors",
+            "SkyrimOutfitEquipmentSystemNativeFuncs",
+            PagedListing::GetArmors);
+        registry->RegisterFunction(
+            "GetListingNames",
+            "SkyrimOutfitEquipmentSystemNativeFuncs",
+            PagedListing::GetNames);
+        registry->RegisterFunction(
+            "CloseListing",
+            "SkyrimOutfitEquipmentSystemNativeFuncs",
+            PagedListing::Close);
+    }
     {// body slot data
+        registry->RegisterFunction(
+            "GetOutfitBodySlotNames",
+            "SkyrimOutfitEquipmentSystemNativeFuncs",
+            BodySlotListing::GetSlotNames);
+        registry->RegisterFunction(
+            "GetOutfitBodySlotIndices",
+            "SkyrimOutfitEquipmentSystemNativeFuncs",
+            BodySlotListing::GetSlotIndices);
+        registry->RegisterFunction(
+            "GetOutfitBodySlotArmorNames",
+            "SkyrimOutfitEquipmentSystemNativeFuncs",
+            BodySlotListing::GetArmorNames);
+        registry->RegisterFunction(
+            "GetOutfitBodySlotArmorForms",
+            "SkyrimOutfitEquipmentSystemNativeFuncs",
+            BodySlotListing::GetArmorForms);
         registry->RegisterFunction(
             "PrepOutfitBodySlotListing",
             "SkyrimOutfitEquipmentSystemNativeFuncs",
@@ -1881,15 +2061,15 @@ bool OutfitSystem::RegisterPapyrus(RE::BSScript::IVirtualMachine* registry) {
         registry->RegisterFunction(
             "GetOutfitBodySlotListingArmorForms",
             "SkyrimOutfitEquipmentSystemNativeFuncs",
-            BodySlotListing::GetArmorForms);
+            BodySlotListing::GetPreparedArmorForms);
         registry->RegisterFunction(
             "GetOutfitBodySlotListingArmorNames",
             "SkyrimOutfitEquipmentSystemNativeFuncs",
-            BodySlotListing::GetArmorNames);
+            BodySlotListing::GetPreparedArmorNames);
         registry->RegisterFunction(
             "GetOutfitBodySlotListingSlotIndices",
             "SkyrimOutfitEquipmentSystemNativeFuncs",
-            BodySlotListing::GetSlotIndices);
+            BodySlotListing::GetPreparedSlotIndices);
         registry->RegisterFunction(
             "ClearOutfitBodySlotListing",
             "SkyrimOutfitEquipmentSystemNativeFuncs",
@@ -1960,6 +2140,14 @@ bool OutfitSystem::RegisterPapyrus(RE::BSScript::IVirtualMachine* registry) {
         "ListOutfits",
         "SkyrimOutfitEquipmentSystemNativeFuncs",
         ListOutfits);
+    registry->RegisterFunction(
+        "ListOutfitsSorted",
+        "SkyrimOutfitEquipmentSystemNativeFuncs",
+        ListOutfitsSorted);
+    registry->RegisterFunction(
+        "CountOutfits",
+        "SkyrimOutfitEquipmentSystemNativeFuncs",
+        CountOutfits);
     registry->RegisterFunction(
         "RemoveArmorFromOutfit",
         "SkyrimOutfitEquipmentSystemNativeFuncs",
@@ -2036,6 +2224,10 @@ bool OutfitSystem::RegisterPapyrus(RE::BSScript::IVirtualMachine* registry) {
         "GetLocationOutfit",
         "SkyrimOutfitEquipmentSystemNativeFuncs",
         GetLocationOutfit);
+    registry->RegisterFunction(
+        "GetLocationOutfits",
+        "SkyrimOutfitEquipmentSystemNativeFuncs",
+        GetLocationOutfits);
     registry->RegisterFunction(
         "ExportSettings",
         "SkyrimOutfitEquipmentSystemNativeFuncs",
@@ -2044,6 +2236,40 @@ bool OutfitSystem::RegisterPapyrus(RE::BSScript::IVirtualMachine* registry) {
         "ImportSettings",
         "SkyrimOutfitEquipmentSystemNativeFuncs",
         ImportSettings);
+    registry->RegisterFunction(
+        "ExportOutfitLibrary",
+        "SkyrimOutfitEquipmentSystemNativeFuncs",
+        ExportOutfitLibrary);
+    registry->RegisterFunction(
+        "ExportGlobalOutfitLibrary",
+        "SkyrimOutfitEquipmentSystemNativeFuncs",
+        ExportGlobalOutfitLibrary);
+    registry->RegisterFunction(
+        "ImportOutfitLibrary",
+        "SkyrimOutfitEquipmentSystemNativeFuncs",
+        ImportOutfitLibrary);
+    registry->RegisterFunction(
+        "GetSettingsTransferStatus",
+        "SkyrimOutfitEquipmentSystemNativeFuncs",
+        GetSettingsTransferStatus);
+    registry->RegisterFunction(
+        "GetSettingsTransferJob",
+        "SkyrimOutfitEquipmentSystemNativeFuncs",
+        GetSettingsTransferJob);
+    {// jobs
+        registry->RegisterFunction(
+            "GetJobStatus",
+            "SkyrimOutfitEquipmentSystemNativeFuncs",
+            GetJobStatus);
+        registry->RegisterFunction(
+            "GetJobProgress",
+            "SkyrimOutfitEquipmentSystemNativeFuncs",
+            GetJobProgress);
+        registry->RegisterFunction(
+            "GetJobResult",
+            "SkyrimOutfitEquipmentSystemNativeFuncs",
+            GetJobResult);
+    }
     registry->RegisterFunction(
         "GetAllLoadedOutfitModsList",
         "SkyrimOutfitEquipmentSystemNativeFuncs",
@@ -2072,6 +2298,14 @@ bool OutfitSystem::RegisterPapyrus(RE::BSScript::IVirtualMachine* registry) {
             "AddAllOutfitsFromModToOutfitList",
             "SkyrimOutfitEquipmentSystemNativeFuncs",
             AddAllOutfitsFromModToOutfitList);
+    registry->RegisterFunction(
+        "StartAddAllOutfitsFromModToOutfitList",
+        "SkyrimOutfitEquipmentSystemNativeFuncs",
+        StartAddAllOutfitsFromModToOutfitList);
+    registry->RegisterFunction(
+        "StartRefreshModCache",
+        "SkyrimOutfitEquipmentSystemNativeFuncs",
+        StartRefreshModCache);
     registry->RegisterFunction(
                 "AutoOutfitSwitchStateReset",
                 "SkyrimOutfitEquipmentSystemNativeFuncs",
@@ -2100,6 +2334,10 @@ bool OutfitSystem::RegisterPapyrus(RE::BSScript::IVirtualMachine* registry) {
         "UnsetLoveSceneForActors",
         "SkyrimOutfitEquipmentSystemNativeFuncs",
         UnsetLoveSceneForActors);
+    registry->RegisterFunction(
+        "DumpNativeProfile",
+        "SkyrimOutfitEquipmentSystemNativeFuncs",
+        DumpNativeProfile);
     registry->RegisterFunction(
         "GetIniOptionValueFor",
         "SkyrimOutfitEquipmentSystemNativeFuncs",
@@ -5,32 +5,28 @@
 #include "Forms.h"
 #include "OutfitSystemCacheService.h"
 
-#include <google/protobuf/util/json_util.h>
-
 OutfitSystemCacheService::OutfitSystemCacheService(const proto::OutfitSystemCache& data) {
     try {
-        std::string protoData;
-        google::protobuf::util::JsonPrintOptions options;
-        options.add_whitespace = true;
-        auto status = google::protobuf::util::MessageToJsonString(data, &protoData, options);
-
         ActorVirtualInventoryStashes stashes;
+        Forms::ResolutionContext forms;
 
-        EXTRALOG(info, "Reading the following stored outfit system cache data:\n {}", protoData);
+        if (Settings::ExtraLoggingEnabled()) {
+            EXTRALOG(info, "Reading the following stored outfit system cache data:\n {}", ProtoUtils::readMessageAsJSON(data));
+        }
 
         for (const auto& actorStash : data.actor_virtual_inventory_stashes()) {
             // Lookup the actor
             std::uint64_t handle;
             const std::string& actorRefFormString = actorStash.actor_ref_form_string();
 
-            RE::Actor* actor = skyrim_cast<RE::Actor*>(Forms::ParseFormString(actorRefFormString));
+            RE::Actor* actor = skyrim_cast<RE::Actor*>(forms.parse(actorRefFormString));
 
             if (!actor) continue;
 
             std::unordered_set<RE::TESObjectARMO*> armors;
 
             for (const auto& armorFormString : actorStash.armors_form_strings()) {
-                RE::TESObjectARMO* armor = skyrim_cast<RE::TESObjectARMO*>(Forms::ParseFormString(armorFormString));
+                RE::TESObjectARMO* armor = skyrim_cast<RE::TESObjectARMO*>(forms.parse(armorFormString));
 
                 if (!armor) continue;
 
@@ -54,17 +50,24 @@ OutfitSystemCacheService::OutfitSystemCacheService(const proto::OutfitSystemCach
 
 proto::OutfitSystemCache OutfitSystemCacheService::save() {
     proto::OutfitSystemCache out;
+    auto& formStrings = Forms::FormStringCache::GetSingleton();
+    std::vector<RE::TESForm*> forms;
+    std::vector<std::string_view> strings;
 
     for (const auto& [actor, armors] : actorVirtualInventoryStashes) {
         // Create a new stash message pointer
         proto::ActorVirtualInventoryStash* stashOut = out.add_actor_virtual_inventory_stashes();
 
         // Set the fields on the created message
-        stashOut->set_actor_ref_form_string(Forms::GetFormString(actor));
+        const auto actorString = formStrings.format(actor);
+        stashOut->set_actor_ref_form_string(actorString.data(), actorString.size());
 
         // Add each armor formID to the repeated field
-        for (const auto& armor : armors) {
-            stashOut->add_armors_form_strings(Forms::GetFormString(armor));
+        forms.assign(armors.begin(), armors.end());
+        formStrings.formatAll(forms, strings);
+        stashOut->mutable_armors_form_strings()->Reserve(static_cast<int>(strings.size()));
+        for (const auto& armorString : strings) {
+            stashOut->add_armors_form_strings(armorString.data(), armorString.size());
         }
     }
 
@@ -9,6 +9,7 @@
 #include <SKSE/SKSE.h>
 
 #include "INIReader.h"
+#include "NativeProfiler.h"
 #include "SKSE/Impl/PCH.h"
 #include "Utility.h"
 
@@ -44,13 +45,17 @@ namespace Plugin {
     inline constexpr auto NAME = "SkyrimOutfitEquipmentSystemNG"sv;
 }  // namespace Plugin
 
+// Traces a native's entry and exit, and times it for NativeProfiler.
 class LogExit {
 public:
     std::string_view m_string;
+    std::chrono::steady_clock::time_point m_start;
     LogExit(std::string_view name) : m_string(name) {
         EXTRALOG(trace, "Enter {}", m_string);
+        m_start = std::chrono::steady_clock::now();
     };
     ~LogExit() {
+        NativeProfiler::Record(m_string, std::chrono::steady_clock::now() - m_start);
         EXTRALOG(trace, "Exit {}", m_string);
     };
 };
@@ -0,0 +1,191 @@
+#include "SettingsTransferService.h"
+
+#include <filesystem>
+#include <fstream>
+
+#include "ArmorAddonOverrideService.h"
+#include "GlobalOutfitLibrary.h"
+#include "Utility.h"
+#include "google/protobuf/util/json_util.h"
+
+std::string SettingsTransferService::GetConfigPath() {
+    return GetRuntimeDirectory() + "Data\\SKSE\\Plugins\\OutfitEquipmentSystemNGData.json";
+}
+
+bool SettingsTransferService::IsBusy() const noexcept {
+    const auto current = status.load();
+    return current == Status::kExporting || current == Status::kImporting;
+}
+
+bool SettingsTransferService::TryBegin(Status running) noexcept {
+    auto current = status.load();
+    do {
+        if (current == Status::kExporting || current == Status::kImporting)
+            return false;
+    } while (!status.compare_exchange_weak(current, running));
+    return true;
+}
+
+JobService::JobID SettingsTransferService::Run(const char* kind, JobService::Work work) {
+    // Finishing through here keeps the transfer status from getting stuck on a transfer that threw.
+    const auto id = JobService::GetSingleton().Start(kind, [this, work = std::move(work)](const JobPtr& job) {
+        try {
+            work(job);
+        } catch (const std::exception& e) {
+            Finish(job, false, fmt::format("The transfer failed: {}", e.what()));
+        }
+    })->id();
+    job = id;
+    return id;
+}
+
+void SettingsTransferService::Finish(const JobPtr& job, bool succeeded, std::string message, std::int32_t result) {
+    LOG(info, "{}", message);
+    status = succeeded ? Status::kSucceeded : Status::kFailed;
+    job->finish(succeeded, result);
+    // Notifications have to be raised from the main thread.
+    SKSE::GetTaskInterface()->AddTask([message = std::move(message)]() {
+        REUtilities::DebugNotification(message);
+    });
+}
+
+JobService::JobID SettingsTransferService::StartExport(proto::OutfitSystem snapshot) {
+    if (!TryBegin(Status::kExporting))
+        return JobService::kNoJob;
+    return Run("ExportSettings", [this, snapshot = std::move(snapshot), outputFile = GetConfigPath()](const JobPtr& job) mutable {
+        ExportThreadFunc(job, std::move(snapshot), std::move(outputFile));
+    });
+}
+
+JobService::JobID SettingsTransferService::StartImport() {
+    if (!TryBegin(Status::kImporting))
+        return JobService::kNoJob;
+    return Run("ImportSettings", [this, inputFile = GetConfigPath()](const JobPtr& job) mutable {
+        ImportThreadFunc(job, std::move(inputFile));
+    });
+}
+
+JobService::JobID SettingsTransferService::StartLibraryExport(OutfitLibrary::ExportData data) {
+    if (!TryBegin(Status::kExporting))
+        return JobService::kNoJob;
+    return Run("ExportOutfitLibrary", [this, data = std::move(data)](const JobPtr& job) mutable {
+        LibraryExportThreadFunc(job, std::move(data));
+    });
+}
+
+JobService::JobID SettingsTransferService::StartGlobalLibraryExport(std::string contents) {
+    if (!TryBegin(Status::kExporting))
+        return JobService::kNoJob;
+    return Run("ExportGlobalOutfitLibrary", [this, contents = std::move(contents)](const JobPtr& job) mutable {
+        GlobalLibraryExportThreadFunc(job, std::move(contents));
+    });
+}
+
+JobService::JobID SettingsTransferService::StartLibraryImport() {
+    if (!TryBegin(Status::kImporting))
+        return JobService::kNoJob;
+    return Run("ImportOutfitLibrary", [this](const JobPtr& job) {
+        LibraryImportThreadFunc(job);
+    });
+}
+
+namespace {
+    // Writes next to the target and renames over it, so a failed export never leaves a truncated file behind.
+    const char* WriteFileAtomically(const std::string& outputFile, const std::string& contents) {
+        const std::string tempFile = outputFile + ".tmp";
+        {
+            std::ofstream file(tempFile, std::ios::binary | std::ios::trunc);
+            if (!file)
+                return "Failed to open config for writing";
+            file.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+            if (!file.good())
+                return "Failed to write config";
+        }
+        std::error_code error;
+        std::filesystem::rename(tempFile, outputFile, error);
+        if (error) {
+            std::filesystem::remove(tempFile, error);
+            return "Failed to write config";
+        }
+        return nullptr;
+    }
+}
+
+void SettingsTransferService::ExportThreadFunc(const JobPtr& job, proto::OutfitSystem snapshot, std::string outputFile) {
+    std::string output;
+    google::protobuf::util::JsonPrintOptions options;
+    options.add_whitespace = true;
+    if (!google::protobuf::util::MessageToJsonString(snapshot, &output, options).ok()) {
+        Finish(job, false, "Failed to convert config to JSON");
+        return;
+    }
+    if (const char* error = WriteFileAtomically(outputFile, output)) {
+        Finish(job, false, error);
+        return;
+    }
+    Finish(job, true, "Wrote JSON config to " + outputFile);
+}
+
+void SettingsTransferService::GlobalLibraryExportThreadFunc(const JobPtr& job, std::string contents) {
+    if (const char* error = WriteFileAtomically(GlobalOutfitLibrary::GetPendingPath(), contents)) {
+        Finish(job, false, error);
+        return;
+    }
+    Finish(job, true, "Wrote the global outfit library; it will be used from the next game start");
+}
+
+void SettingsTransferService::ImportThreadFunc(const JobPtr& job, std::string inputFile) {
+    std::string input;
+    {
+        std::ifstream file(inputFile, std::ios::binary | std::ios::ate);
+        if (!file) {
+            Finish(job, false, "Failed to open config for reading");
+            return;
+        }
+        input.resize(static_cast<std::size_t>(file.tellg()));
+        file.seekg(0);
+        file.read(input.data(), static_cast<std::streamsize>(input.size()));
+        if (!file.good()) {
+            Finish(job, false, "Failed to read config data");
+            return;
+        }
+    }
+
+    proto::OutfitSystem data;
+    if (!google::protobuf::util::JsonStringToMessage(input, &data).ok()) {
+        Finish(job, false, "Failed to parse config data. Invalid syntax.");
+        return;
+    }
+
+    // Form lookups only read the (already loaded) form tables, so the new state can be built here; only the swap
+    // itself has to wait for the main thread.
+    auto imported = std::make_shared<ArmorAddonOverrideService>(data, SKSE::GetSerializationInterface());
+    SKSE::GetTaskInterface()->AddTask([this, job, imported, inputFile = std::move(inputFile)]() {
+        auto& service = ArmorAddonOverrideService::GetInstance();
+        service = std::move(*imported);
+        service.attachGlobalLibrary();
+        Finish(job, true, "Read JSON config from " + inputFile);
+    });
+}
+
+void SettingsTransferService::LibraryExportThreadFunc(const JobPtr& job, OutfitLibrary::ExportData data) {
+    std::string error;
+    if (!OutfitLibrary::WriteExport(data, error)) {
+        Finish(job, false, error);
+        return;
+    }
+    Finish(job, true, fmt::format("Wrote {} outfits to the outfit library", data.files.size()));
+}
+
+void SettingsTransferService::LibraryImportThreadFunc(const JobPtr& job) {
+    proto::OutfitLibraryIndex index;
+    if (!OutfitLibrary::ReadIndex(index)) {
+        Finish(job, false, "Failed to read the outfit library index");
+        return;
+    }
+    // Only the index is read here; the outfits themselves are read from the library when they're first used.
+    SKSE::GetTaskInterface()->AddTask([this, job, index = std::move(index)]() {
+        const auto added = OutfitLibrary::ImportIndex(ArmorAddonOverrideService::GetInstance(), index);
+        Finish(job, true, fmt::format("Added {} outfits from the outfit library", added), added);
+    });
+}
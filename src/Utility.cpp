@@ -4,6 +4,8 @@
 
 #include "Utility.h"
 
+#include <sstream>
+
 #include "Forms.h"
 #include "SKSE/SKSE.h"
 
@@ -195,6 +197,17 @@ bool Settings::AllowExternalEquipment() {
     return result.has_value() ? result.value() : SettingsDefaults::AllowExternalEquipment;
 }
 
+bool Settings::UseGlobalLibrary() {
+    static std::optional<bool> result;
+
+    if (!result.has_value()) {
+        result = Instance()->GetBoolean("Library", "UseGlobalLibrary", SettingsDefaults::UseGlobalLibrary);
+        EXTRALOG(info, "UseGlobalLibrary set as {}", result.value());
+    }
+
+    return result.has_value() ? result.value() : SettingsDefaults::UseGlobalLibrary;
+}
+
 void REUtilities::DebugNotification(const std::string& notification) {
     RE::DebugNotification(notification.c_str());
 }
@@ -1,6 +1,8 @@
 #include "cobb/utf8naturalsort.h"
 #include "cobb/utf8string.h"
-#include <cwctype>
+#include <algorithm>
+#include <execution>
+#include <numeric>
 
 inline static bool isNumber(const char c) {
     return c >= '0' && c <= '9';
@@ -8,55 +10,67 @@ inline static bool isNumber(const char c) {
 
 namespace cobb {
     namespace utf8 {
-        int32_t naturalcompare(const std::string& a, const std::string& b) {
-            auto i_a = a.begin();
-            auto i_b = b.begin();
-            for (; i_a != a.end() && i_b != b.end(); ++i_a, ++i_b) {
-                unicodechar c_a = utf8::get(a, i_a);
-                unicodechar c_b = utf8::get(b, i_b);
-                if (!isNumber(c_a) || !isNumber(c_b)) {
+        void naturalkey(std::string_view text, std::string& out) {
+            out.clear();
+            out.reserve(text.size() + 4);
+            std::size_t i = 0;
+            while (i < text.size()) {
+                std::size_t end = i;
+                if (!isNumber(text[i])) {
                     //
-                    // For non-numeric characters, just do a character code comparison.
-                    // This won't internationalize -- it won't even handle accented
-                    // characters in English.
+                    // Folded text stays UTF-8, which preserves code point order under byte comparison.
                     //
-                    c_a = std::towlower(c_a);// not sure about this; seems to use two-byte chars when unicode can be up to four bytes, no?
-                    c_b = std::towlower(c_b);// then again, anything past the two-byte mark probably isn't even a "letter" as Westerners conceive of them...
-                    if (c_a == c_b) {
-                        if (i_a == a.end() || i_b == b.end()) break;
-                        continue;
-                    }
-                    return c_b - c_a;
-                }
-                std::uint32_t n_a = c_a - '0';
-                std::uint32_t n_b = c_b - '0';
-                ++i_a;
-                ++i_b;
-                for (; i_a != a.end(); ++i_a) {
-                    c_a = utf8::get(a, i_a);
-                    if (!isNumber(c_a))
-                        break;
-                    n_a = (n_a * 10) + (c_a - '0');
+                    while (end < text.size() && !isNumber(text[end]))
+                        ++end;
+                    utf8::fold(text.substr(i, end - i), out);
+                    i = end;
+                    continue;
                 }
-                for (; i_b != b.end(); ++i_b) {
-                    c_b = utf8::get(b, i_b);
-                    if (!isNumber(c_b))
-                        break;
-                    n_b = (n_b * 10) + (c_b - '0');
-                }
-                if (n_a != n_b)
-                    return n_b - n_a;
-                if (i_a == a.end() || i_b == b.end()) break;
+                while (end < text.size() && isNumber(text[end]))
+                    ++end;
+                while (i + 1 < end && text[i] == '0')// leading zeros don't change the value
+                    ++i;
+                //
+                // The marker sorts exactly where a digit would against any other glyph. Past it, a longer run of
+                // significant digits is a larger number; runs of equal length compare digit by digit.
+                //
+                const std::size_t digits = end - i;
+                out.push_back('0');
+                out.push_back(static_cast<char>((digits >> 8) & 0xFF));
+                out.push_back(static_cast<char>(digits & 0xFF));
+                out.append(text.substr(i, digits));
+                i = end;
             }
+        }
+        int32_t naturalcompare(const std::string& a, const std::string& b) {
+            std::string key_a;
+            std::string key_b;
+            naturalkey(a, key_a);
+            naturalkey(b, key_b);
+            return key_b.compare(key_a);
+        }
+        std::vector<std::uint32_t> naturalorder(std::span<const std::string_view> texts, bool descending) {
             //
-            // If we've reached this point, then we've reached the end of ONE OF the
-            // strings (and they don't end in digits).
+            // Below this, spinning up the parallel algorithms costs more than it saves.
             //
-            if (i_a != a.end())
-                return 1;
-            if (i_b != b.end())
-                return -1;
-            return 0;
+            constexpr std::size_t parallelThreshold = 1 << 14;
+            //
+            std::vector<std::uint32_t> order(texts.size());
+            std::iota(order.begin(), order.end(), 0u);
+            std::vector<std::string> keys(texts.size());
+            const auto makeKey = [&](std::uint32_t i) { naturalkey(texts[i], keys[i]); };
+            const auto before = [&](std::uint32_t a, std::uint32_t b) {
+                const int result = descending ? keys[b].compare(keys[a]) : keys[a].compare(keys[b]);
+                return result != 0 ? result < 0 : a < b;
+            };
+            if (texts.size() >= parallelThreshold) {
+                std::for_each(std::execution::par, order.begin(), order.end(), makeKey);
+                std::sort(std::execution::par, order.begin(), order.end(), before);
+            } else {
+                std::for_each(order.begin(), order.end(), makeKey);
+                std::sort(order.begin(), order.end(), before);
+            }
+            return order;
         }
     }// namespace utf8
 }// namespace cobb
\ No newline at end of file
@@ -1,4 +1,7 @@
 #include "cobb/utf8string.h"
+#include <algorithm>
+#include <bit>
+#include <emmintrin.h>
 
 namespace cobb {
     namespace utf8 {
@@ -40,7 +43,7 @@ namespace cobb {
                 return;
             }
             if (c < 0x800) {
-                target.push_back(0xE0 | ((c >> 6) & 0x1F));
+                target.push_back(0xC0 | ((c >> 6) & 0x1F));
                 target.push_back(0x80 | (c & 0x3F));
                 return;
             }
@@ -50,10 +53,10 @@ namespace cobb {
                 target.push_back(0x80 | (c & 0x3F));
                 return;
             }
-            target.push_back(0xE0 | ((c >> 18) & 0x7));
+            target.push_back(0xF0 | ((c >> 18) & 0x7));
             target.push_back(0x80 | ((c >> 12) & 0x3F));
             target.push_back(0x80 | ((c >> 6) & 0x3F));
-            target.push_back(0x80 | (c & 0x1F));
+            target.push_back(0x80 | (c & 0x3F));
         }
         size_t count(std::string& container) {
             return count_from(container, container.begin());
@@ -190,5 +193,223 @@ namespace cobb {
                 return (a << 0x18) | (b << 0x10) | (c << 0x08) | d;
             }
         }
+        //
+        // Simple case folding (the C and S entries of Unicode 14.0's CaseFolding.txt), as runs of code points that
+        // share one offset. Alternating upper/lowercase blocks are runs with a stride of two.
+        //
+        struct _fold_run {
+            unicodechar   first;
+            unicodechar   last;
+            std::int32_t  delta;
+            std::uint32_t stride;
+        };
+        static constexpr _fold_run _fold_runs[] = {
+            {0x00041, 0x0005A, 32, 1}, {0x000B5, 0x000B5, 775, 1}, {0x000C0, 0x000D6, 32, 1}, {0x000D8, 0x000DE, 32, 1},
+            {0x00100, 0x0012E, 1, 2}, {0x00132, 0x00136, 1, 2}, {0x00139, 0x00147, 1, 2}, {0x0014A, 0x00176, 1, 2},
+            {0x00178, 0x00178, -121, 1}, {0x00179, 0x0017D, 1, 2}, {0x0017F, 0x0017F, -268, 1}, {0x00181, 0x00181, 210, 1},
+            {0x00182, 0x00184, 1, 2}, {0x00186, 0x00186, 206, 1}, {0x00187, 0x00187, 1, 1}, {0x00189, 0x0018A, 205, 1},
+            {0x0018B, 0x0018B, 1, 1}, {0x0018E, 0x0018E, 79, 1}, {0x0018F, 0x0018F, 202, 1}, {0x00190, 0x00190, 203, 1},
+            {0x00191, 0x00191, 1, 1}, {0x00193, 0x00193, 205, 1}, {0x00194, 0x00194, 207, 1}, {0x00196, 0x00196, 211, 1},
+            {0x00197, 0x00197, 209, 1}, {0x00198, 0x00198, 1, 1}, {0x0019C, 0x0019C, 211, 1}, {0x0019D, 0x0019D, 213, 1},
+            {0x0019F, 0x0019F, 214, 1}, {0x001A0, 0x001A4, 1, 2}, {0x001A6, 0x001A6, 218, 1}, {0x001A7, 0x001A7, 1, 1},
+            {0x001A9, 0x001A9, 218, 1}, {0x001AC, 0x001AC, 1, 1}, {0x001AE, 0x001AE, 218, 1}, {0x001AF, 0x001AF, 1, 1},
+            {0x001B1, 0x001B2, 217, 1}, {0x001B3, 0x001B5, 1, 2}, {0x001B7, 0x001B7, 219, 1}, {0x001B8, 0x001B8, 1, 1},
+            {0x001BC, 0x001BC, 1, 1}, {0x001C4, 0x001C4, 2, 1}, {0x001C5, 0x001C5, 1, 1}, {0x001C7, 0x001C7, 2, 1},
+            {0x001C8, 0x001C8, 1, 1}, {0x001CA, 0x001CA, 2, 1}, {0x001CB, 0x001DB, 1, 2}, {0x001DE, 0x001EE, 1, 2},
+            {0x001F1, 0x001F1, 2, 1}, {0x001F2, 0x001F4, 1, 2}, {0x001F6, 0x001F6, -97, 1}, {0x001F7, 0x001F7, -56, 1},
+            {0x001F8, 0x0021E, 1, 2}, {0x00220, 0x00220, -130, 1}, {0x00222, 0x00232, 1, 2}, {0x0023A, 0x0023A, 10795, 1},
+            {0x0023B, 0x0023B, 1, 1}, {0x0023D, 0x0023D, -163, 1}, {0x0023E, 0x0023E, 10792, 1}, {0x00241, 0x00241, 1, 1},
+            {0x00243, 0x00243, -195, 1}, {0x00244, 0x00244, 69, 1}, {0x00245, 0x00245, 71, 1}, {0x00246, 0x0024E, 1, 2},
+            {0x00345, 0x00345, 116, 1}, {0x00370, 0x00372, 1, 2}, {0x00376, 0x00376, 1, 1}, {0x0037F, 0x0037F, 116, 1},
+            {0x00386, 0x00386, 38, 1}, {0x00388, 0x0038A, 37, 1}, {0x0038C, 0x0038C, 64, 1}, {0x0038E, 0x0038F, 63, 1},
+            {0x00391, 0x003A1, 32, 1}, {0x003A3, 0x003AB, 32, 1}, {0x003C2, 0x003C2, 1, 1}, {0x003CF, 0x003CF, 8, 1},
+            {0x003D0, 0x003D0, -30, 1}, {0x003D1, 0x003D1, -25, 1}, {0x003D5, 0x003D5, -15, 1}, {0x003D6, 0x003D6, -22, 1},
+            {0x003D8, 0x003EE, 1, 2}, {0x003F0, 0x003F0, -54, 1}, {0x003F1, 0x003F1, -48, 1}, {0x003F4, 0x003F4, -60, 1},
+            {0x003F5, 0x003F5, -64, 1}, {0x003F7, 0x003F7, 1, 1}, {0x003F9, 0x003F9, -7, 1}, {0x003FA, 0x003FA, 1, 1},
+            {0x003FD, 0x003FF, -130, 1}, {0x00400, 0x0040F, 80, 1}, {0x00410, 0x0042F, 32, 1}, {0x00460, 0x00480, 1, 2},
+            {0x0048A, 0x004BE, 1, 2}, {0x004C0, 0x004C0, 15, 1}, {0x004C1, 0x004CD, 1, 2}, {0x004D0, 0x0052E, 1, 2},
+            {0x00531, 0x00556, 48, 1}, {0x010A0, 0x010C5, 7264, 1}, {0x010C7, 0x010C7, 7264, 1}, {0x010CD, 0x010CD, 7264, 1},
+            {0x013F8, 0x013FD, -8, 1}, {0x01C80, 0x01C80, -6222, 1}, {0x01C81, 0x01C81, -6221, 1}, {0x01C82, 0x01C82, -6212, 1},
+            {0x01C83, 0x01C84, -6210, 1}, {0x01C85, 0x01C85, -6211, 1}, {0x01C86, 0x01C86, -6204, 1}, {0x01C87, 0x01C87, -6180, 1},
+            {0x01C88, 0x01C88, 35267, 1}, {0x01C90, 0x01CBA, -3008, 1}, {0x01CBD, 0x01CBF, -3008, 1}, {0x01E00, 0x01E94, 1, 2},
+            {0x01E9B, 0x01E9B, -58, 1}, {0x01E9E, 0x01E9E, -7615, 1}, {0x01EA0, 0x01EFE, 1, 2}, {0x01F08, 0x01F0F, -8, 1},
+            {0x01F18, 0x01F1D, -8, 1}, {0x01F28, 0x01F2F, -8, 1}, {0x01F38, 0x01F3F, -8, 1}, {0x01F48, 0x01F4D, -8, 1},
+            {0x01F59, 0x01F5F, -8, 2}, {0x01F68, 0x01F6F, -8, 1}, {0x01F88, 0x01F8F, -8, 1}, {0x01F98, 0x01F9F, -8, 1},
+            {0x01FA8, 0x01FAF, -8, 1}, {0x01FB8, 0x01FB9, -8, 1}, {0x01FBA, 0x01FBB, -74, 1}, {0x01FBC, 0x01FBC, -9, 1},
+            {0x01FBE, 0x01FBE, -7173, 1}, {0x01FC8, 0x01FCB, -86, 1}, {0x01FCC, 0x01FCC, -9, 1}, {0x01FD8, 0x01FD9, -8, 1},
+            {0x01FDA, 0x01FDB, -100, 1}, {0x01FE8, 0x01FE9, -8, 1}, {0x01FEA, 0x01FEB, -112, 1}, {0x01FEC, 0x01FEC, -7, 1},
+            {0x01FF8, 0x01FF9, -128, 1}, {0x01FFA, 0x01FFB, -126, 1}, {0x01FFC, 0x01FFC, -9, 1}, {0x02126, 0x02126, -7517, 1},
+            {0x0212A, 0x0212A, -8383, 1}, {0x0212B, 0x0212B, -8262, 1}, {0x02132, 0x02132, 28, 1}, {0x02160, 0x0216F, 16, 1},
+            {0x02183, 0x02183, 1, 1}, {0x024B6, 0x024CF, 26, 1}, {0x02C00, 0x02C2F, 48, 1}, {0x02C60, 0x02C60, 1, 1},
+            {0x02C62, 0x02C62, -10743, 1}, {0x02C63, 0x02C63, -3814, 1}, {0x02C64, 0x02C64, -10727, 1}, {0x02C67, 0x02C6B, 1, 2},
+            {0x02C6D, 0x02C6D, -10780, 1}, {0x02C6E, 0x02C6E, -10749, 1}, {0x02C6F, 0x02C6F, -10783, 1}, {0x02C70, 0x02C70, -10782, 1},
+            {0x02C72, 0x02C72, 1, 1}, {0x02C75, 0x02C75, 1, 1}, {0x02C7E, 0x02C7F, -10815, 1}, {0x02C80, 0x02CE2, 1, 2},
+            {0x02CEB, 0x02CED, 1, 2}, {0x02CF2, 0x02CF2, 1, 1}, {0x0A640, 0x0A66C, 1, 2}, {0x0A680, 0x0A69A, 1, 2},
+            {0x0A722, 0x0A72E, 1, 2}, {0x0A732, 0x0A76E, 1, 2}, {0x0A779, 0x0A77B, 1, 2}, {0x0A77D, 0x0A77D, -35332, 1},
+            {0x0A77E, 0x0A786, 1, 2}, {0x0A78B, 0x0A78B, 1, 1}, {0x0A78D, 0x0A78D, -42280, 1}, {0x0A790, 0x0A792, 1, 2},
+            {0x0A796, 0x0A7A8, 1, 2}, {0x0A7AA, 0x0A7AA, -42308, 1}, {0x0A7AB, 0x0A7AB, -42319, 1}, {0x0A7AC, 0x0A7AC, -42315, 1},
+            {0x0A7AD, 0x0A7AD, -42305, 1}, {0x0A7AE, 0x0A7AE, -42308, 1}, {0x0A7B0, 0x0A7B0, -42258, 1}, {0x0A7B1, 0x0A7B1, -42282, 1},
+            {0x0A7B2, 0x0A7B2, -42261, 1}, {0x0A7B3, 0x0A7B3, 928, 1}, {0x0A7B4, 0x0A7C2, 1, 2}, {0x0A7C4, 0x0A7C4, -48, 1},
+            {0x0A7C5, 0x0A7C5, -42307, 1}, {0x0A7C6, 0x0A7C6, -35384, 1}, {0x0A7C7, 0x0A7C9, 1, 2}, {0x0A7D0, 0x0A7D0, 1, 1},
+            {0x0A7D6, 0x0A7D8, 1, 2}, {0x0A7F5, 0x0A7F5, 1, 1}, {0x0AB70, 0x0ABBF, -38864, 1}, {0x0FF21, 0x0FF3A, 32, 1},
+            {0x10400, 0x10427, 40, 1}, {0x104B0, 0x104D3, 40, 1}, {0x10570, 0x1057A, 39, 1}, {0x1057C, 0x1058A, 39, 1},
+            {0x1058C, 0x10592, 39, 1}, {0x10594, 0x10595, 39, 1}, {0x10C80, 0x10CB2, 64, 1}, {0x118A0, 0x118BF, 32, 1},
+            {0x16E40, 0x16E5F, 32, 1}, {0x1E900, 0x1E921, 34, 1},
+        };
+        //
+        inline static char _ascii_fold(char c) {
+            return (c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c;
+        }
+        inline static std::size_t _encoded_length(unicodechar c) {
+            return c < 0x80 ? 1 : c < 0x800 ? 2 : c < 0x10000 ? 3 : 4;
+        }
+        inline static std::size_t _sequence_length(unsigned char lead) {
+            return lead >= 0xF0 && lead < 0xF8 ? 4 : lead >= 0xE0 && lead < 0xF0 ? 3 : lead >= 0xC0 && lead < 0xE0 ? 2 : 1;
+        }
+        //
+        // Decodes the sequence of the given length at text; returns false if it's malformed.
+        //
+        static bool _decode(const char* text, std::size_t length, unicodechar& out) {
+            const unsigned char lead = text[0];
+            out = lead & (0x7F >> length);
+            for (std::size_t k = 1; k < length; ++k) {
+                const unsigned char c = text[k];
+                if (!_is_continuation(c))
+                    return false;
+                out = (out << 6) | (c & 0x3F);
+            }
+            return true;
+        }
+        //
+        // Lowercases the ASCII letters of a 16-byte block. Bytes >= 0x80 compare as negative and are left alone.
+        //
+        inline static __m128i _ascii_fold_block(__m128i block) {
+            const __m128i upperA  = _mm_set1_epi8('A' - 1);
+            const __m128i upperZ  = _mm_set1_epi8('Z' + 1);
+            const __m128i caseBit = _mm_set1_epi8(0x20);
+            const __m128i isUpper = _mm_and_si128(_mm_cmpgt_epi8(block, upperA), _mm_cmplt_epi8(block, upperZ));
+            return _mm_or_si128(block, _mm_and_si128(isUpper, caseBit));
+        }
+        //
+        unicodechar fold(unicodechar c) {
+            if (c < 0x80)
+                return _ascii_fold(c);
+            auto it = std::upper_bound(std::begin(_fold_runs), std::end(_fold_runs), c, [](unicodechar c, const _fold_run& run) { return c < run.first; });
+            if (it == std::begin(_fold_runs))
+                return c;
+            --it;
+            if (c > it->last || (c - it->first) % it->stride != 0)
+                return c;
+            return c + it->delta;
+        }
+        void fold(std::string_view text, std::string& out) {
+            out.reserve(out.size() + text.size());
+            const char* data = text.data();
+            std::size_t i = 0;
+            while (i < text.size()) {
+                if (i + 16 <= text.size()) {
+                    const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+                    if (_mm_movemask_epi8(block) == 0) {
+                        char folded[16];
+                        _mm_storeu_si128(reinterpret_cast<__m128i*>(folded), _ascii_fold_block(block));
+                        out.append(folded, 16);
+                        i += 16;
+                        continue;
+                    }
+                }
+                const std::size_t length = _sequence_length(data[i]);
+                unicodechar c;
+                if (length == 1 || i + length > text.size() || !_decode(data + i, length, c)) {
+                    out.push_back(_ascii_fold(data[i]));// ASCII, or a malformed byte kept as-is
+                    ++i;
+                    continue;
+                }
+                append(out, fold(c));
+                i += length;
+            }
+        }
+        int compare_folded(const char* a, const char* b, std::size_t n) {
+            std::size_t i = 0;
+            while (i < n) {
+                if (i + 16 <= n) {
+                    const __m128i block_a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+                    const __m128i block_b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+                    if ((_mm_movemask_epi8(block_a) | _mm_movemask_epi8(block_b)) == 0) {
+                        const auto equal = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_ascii_fold_block(block_a), _ascii_fold_block(block_b))));
+                        if (equal == 0xFFFF) {
+                            i += 16;
+                            continue;
+                        }
+                        i += std::countr_one(equal);
+                        return _ascii_fold(a[i]) - _ascii_fold(b[i]);
+                    }
+                }
+                const unsigned char c_a = a[i];
+                const unsigned char c_b = b[i];
+                const std::size_t length = _sequence_length(c_a);
+                unicodechar g_a;
+                unicodechar g_b;
+                if (length == 1 || length != _sequence_length(c_b) || i + length > n || !_decode(a + i, length, g_a) || !_decode(b + i, length, g_b)) {
+                    //
+                    // Folding never moves a byte across the ASCII boundary, so single bytes compare as themselves.
+                    //
+                    const int difference = static_cast<unsigned char>(_ascii_fold(c_a)) - static_cast<unsigned char>(_ascii_fold(c_b));
+                    if (difference)
+                        return difference;
+                    ++i;
+                    continue;
+                }
+                //
+                // Only folds that keep the encoded length count here, so that a string's byte length (which
+                // basic_string uses to break ties) stays meaningful and the order stays consistent.
+                //
+                unicodechar f_a = fold(g_a);
+                unicodechar f_b = fold(g_b);
+                if (_encoded_length(f_a) != length)
+                    f_a = g_a;
+                if (_encoded_length(f_b) != length)
+                    f_b = g_b;
+                if (f_a != f_b)
+                    return f_a < f_b ? -1 : 1;
+                i += length;
+            }
+            return 0;
+        }
+        std::size_t hash_folded(const char* text, std::size_t n) {
+            //
+            // Steps through the text exactly like compare_folded, so strings that compare equal hash equally.
+            //
+            std::uint64_t hash = 0xCBF29CE484222325ull;
+            const auto mix = [&hash](std::uint32_t unit) {
+                hash ^= unit;
+                hash *= 0x100000001B3ull;
+            };
+            std::size_t i = 0;
+            while (i < n) {
+                if (i + 16 <= n) {
+                    const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + i));
+                    if (_mm_movemask_epi8(block) == 0) {
+                        alignas(16) unsigned char folded[16];
+                        _mm_store_si128(reinterpret_cast<__m128i*>(folded), _ascii_fold_block(block));
+                        for (const auto c : folded)
+                            mix(c);
+                        i += 16;
+                        continue;
+                    }
+                }
+                const unsigned char c = text[i];
+                const std::size_t length = _sequence_length(c);
+                unicodechar glyph;
+                if (length == 1 || i + length > n || !_decode(text + i, length, glyph)) {
+                    mix(static_cast<unsigned char>(_ascii_fold(c)));
+                    ++i;
+                    continue;
+                }
+                const unicodechar folded = fold(glyph);
+                mix(_encoded_length(folded) == length ? folded : glyph);
+                i += length;
+            }
+            return static_cast<std::size_t>(hash);
+        }
     }// namespace utf8
 };   // namespace cobb
\ No newline at end of file